@@ -7,11 +7,15 @@
     #include "EventSignalAv.h"
 #elif (EVENT_USE_CPP_DEV_TYPE == EVENT_TYPE_STANDARD)
     #include "EventSignalLst.h"
+    #include "EventChannel.h"
+    #include "EventShardedSignal.h"
 #else 
     #error "!!!!Invlaid EVENT_USE_CPP_DEV_TYPE set!!!!"
 #endif
 
 #include "EventSlot.h"
+#include "EventWiring.h"
+#include "EventPayload.h"
 
 
 #define CONCAT(a, b, c) a##b##c
@@ -39,6 +43,14 @@
 
 #define EVENT_FNC_SLOT(__name__,args...)                                            \
         EventFncSlot<args> EXPAND_AND_CONCAT(EVENT_SLOT_PREFIX, __name__ , EVENT_SLOT_SUFFIX) {EXPAND_AND_CONCAT(EVENT_SLOT_METHOD_PREFIX, __name__, EVENT_SLOT_METHOD_SUFFIX)}
+
+/**
+ * @brief Global Macro definition of the Event Slot Group type calling a Method on many receivers.
+ * @param[in] __CLASS_NAME__ Class of the receivers
+ * @param[in] __METHOD__ Method of the class, must not be overloaded
+ */
+#define EVENT_SLOT_GROUP_TYPE(__CLASS_NAME__, __METHOD__)                           \
+        MethodSlotGroup<__CLASS_NAME__, decltype(&__CLASS_NAME__::__METHOD__), &__CLASS_NAME__::__METHOD__>
 /**
  * @brief Global Macro definiton of Event Signal 2 Slot connector
  */
@@ -102,6 +114,21 @@ template <class... T> using EventSignal = Signal<T...>;
 template <class... T> using EventFncSlot = FunctionSlot<T...>;
 
 
+#if (EVENT_USE_CPP_DEV_TYPE == EVENT_TYPE_STANDARD)
+/**
+ * @brief Global definition of the type EventChannel
+ * @tparam T Datatype of the EventChannel
+ */
+template <class... T> using EventChannel = ChannelSlot<T...>;
+
+/**
+ * @brief Global definition of the type EventShardedSignal
+ * @tparam T Datatype of the EventShardedSignal
+ */
+template <class... T> using EventShardedSignal = ShardedSignal<T...>;
+#endif
+
+
 
 
 
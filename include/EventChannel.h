@@ -0,0 +1,371 @@
+#ifndef EVENTCHANNEL_H
+#define EVENTCHANNEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <condition_variable>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "EventSlot.h"
+
+/**
+ * @brief Forward decleartion of the clas Signal
+ */
+template <class... Type> class Signal;
+
+/**
+ * @brief Enumerate to select what a ChannelSlot does when it is full
+ */
+enum ChannelPolicy
+{
+    ChannelBlock,      /*!< The emitter waits until the consumer made room */
+    ChannelDropNewest, /*!< The new value is dropped */
+    ChannelDropOldest, /*!< The oldest queued value is dropped to make room */
+    ChannelCoalesce    /*!< The newest queued value is replaced by the new value */
+};
+
+/**
+ * @brief Compile time list of tuple indices, used to unpack a queued value into a call
+ */
+template <size_t... Index>
+struct ChannelIndices
+{
+};
+
+template <size_t N, size_t... Index>
+struct ChannelMakeIndices : ChannelMakeIndices<N - 1, N - 1, Index...>
+{
+};
+
+template <size_t... Index>
+struct ChannelMakeIndices<0, Index...>
+{
+    typedef ChannelIndices<Index...> type;
+};
+
+/**
+ * @brief
+ * @tparam Type
+ *
+ * ChannelSlot is a subclass of Slot which does not execute anything when the signal fires. Instead it copies the
+ * arguments into a bounded ring buffer, from which a consumer (usually another thread) takes them with tryReceive(),
+ * receive() or dispatch(). The capacity is fixed at construction, so a slow consumer never makes the buffer grow; the
+ * ChannelPolicy decides what happens to the emitter when the buffer is full. The high-water mark and the drop counters
+ * show how close the channel runs to its limit.
+ *
+ * All methods are thread safe. With ChannelBlock the signal must not be emitted from the consumer thread, otherwise a
+ * full channel waits for itself.
+ */
+template <class... Type>
+class ChannelSlot : public Slot<Type...>
+{
+    typedef std::tuple<typename std::decay<Type>::type...> Item;
+    typedef typename ChannelMakeIndices<sizeof...(Type)>::type Indices;
+
+public:
+    /**
+     * @brief Construct a new Channel Slot object
+     * @param capacity Maximum number of queued emits
+     * @param policy Behaviour when the channel is full
+     */
+    ChannelSlot(uint16_t capacity, ChannelPolicy policy = ChannelDropNewest) : Slot<Type...>(Channel),
+                                                                               m_buffer(capacity > 0 ? capacity : 1),
+                                                                               m_policy(policy),
+                                                                               m_head(0),
+                                                                               m_size(0),
+                                                                               m_high_water(0),
+                                                                               m_dropped(0),
+                                                                               m_coalesced(0),
+                                                                               m_closed(false)
+    {
+    }
+
+    ChannelSlot(const ChannelSlot &) = delete;
+    ChannelSlot &operator=(const ChannelSlot &) = delete;
+
+    /**
+     * @brief
+     * @param param
+     *
+     * Queue the arguments of the emit.
+     */
+    void operator()(Type... args) const
+    {
+        const_cast<ChannelSlot<Type...> *>(this)->push(args...);
+    }
+
+    /**
+     * @brief
+     * @param slot
+     * @return true
+     * @return false
+     *
+     * Compare the slot.
+     */
+    bool operator==(const Slot<Type...> *slot) const
+    {
+        return slot == this;
+    }
+
+    /**
+     * @brief Take the oldest queued emit without waiting
+     * @param args Receive the arguments of the emit
+     * @return true An emit was taken
+     * @return false Channel is empty
+     */
+    bool tryReceive(typename std::decay<Type>::type &...args)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_size == 0)
+        {
+            return false;
+        }
+        std::tie(args...) = std::move(m_buffer[m_head]);
+        pop();
+        return true;
+    }
+
+    /**
+     * @brief Take the oldest queued emit, waits until one is available
+     * @param args Receive the arguments of the emit
+     * @return true An emit was taken
+     * @return false Channel was closed and is empty
+     */
+    bool receive(typename std::decay<Type>::type &...args)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while ((m_size == 0) && !m_closed)
+        {
+            m_not_empty.wait(lock);
+        }
+        if (m_size == 0)
+        {
+            return false;
+        }
+        std::tie(args...) = std::move(m_buffer[m_head]);
+        pop();
+        return true;
+    }
+
+    /**
+     * @brief Forward queued emits to a slot
+     * @param slot Slot which is called for each queued emit
+     * @param max_items Maximum number of emits to forward
+     * @return uint16_t Number of forwarded emits
+     *
+     * The slot is executed without holding the channel lock, so it may emit into this channel again.
+     */
+    uint16_t dispatch(const Slot<Type...> &slot, uint16_t max_items = UINT16_MAX)
+    {
+        uint16_t count = 0;
+        Item item;
+
+        while ((count < max_items) && take(item))
+        {
+            call(slot, item, Indices());
+            count++;
+        }
+        return count;
+    }
+
+    /**
+     * @brief Forward queued emits to a signal
+     * @param signal Signal which is emitted for each queued emit
+     * @param max_items Maximum number of emits to forward
+     * @return uint16_t Number of forwarded emits
+     */
+    uint16_t dispatch(const Signal<Type...> &signal, uint16_t max_items = UINT16_MAX)
+    {
+        uint16_t count = 0;
+        Item item;
+
+        while ((count < max_items) && take(item))
+        {
+            emit(signal, item, Indices());
+            count++;
+        }
+        return count;
+    }
+
+    /**
+     * @brief Close the channel
+     *
+     * Further emits are dropped, blocked emitters and receivers return. Queued emits can still be received.
+     */
+    void close(void)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+        m_not_full.notify_all();
+        m_not_empty.notify_all();
+    }
+
+    /**
+     * @brief Number of queued emits
+     * @return uint16_t
+     */
+    uint16_t size(void) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_size;
+    }
+
+    /**
+     * @brief Maximum number of queued emits
+     * @return uint16_t
+     */
+    uint16_t capacity(void) const
+    {
+        return (uint16_t)m_buffer.size();
+    }
+
+    /**
+     * @brief Highest number of emits which were queued at the same time
+     * @return uint16_t
+     */
+    uint16_t highWater(void) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_high_water;
+    }
+
+    /**
+     * @brief Number of emits lost by ChannelDropNewest, ChannelDropOldest or a closed channel
+     * @return uint32_t
+     */
+    uint32_t dropped(void) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_dropped;
+    }
+
+    /**
+     * @brief Number of emits merged into the newest queued emit by ChannelCoalesce
+     * @return uint32_t
+     */
+    uint32_t coalesced(void) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_coalesced;
+    }
+
+    /**
+     * @brief Reset the high-water mark and the drop counters
+     */
+    void resetCounters(void)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_high_water = m_size;
+        m_dropped = 0;
+        m_coalesced = 0;
+    }
+
+private: /* Methods */
+    /**
+     * @brief Queue an emit according to the overflow policy
+     * @param args Arguments of the emit
+     */
+    void push(Type... args)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        const uint16_t capacity = (uint16_t)m_buffer.size();
+
+        if (m_policy == ChannelBlock)
+        {
+            while ((m_size == capacity) && !m_closed)
+            {
+                m_not_full.wait(lock);
+            }
+        }
+
+        if (m_closed)
+        {
+            m_dropped++;
+            return;
+        }
+
+        if (m_size == capacity)
+        {
+            switch (m_policy)
+            {
+            case ChannelDropOldest:
+                pop();
+                m_dropped++;
+                break;
+            case ChannelCoalesce:
+                m_buffer[(m_head + m_size - 1) % capacity] = Item(args...);
+                m_coalesced++;
+                return;
+            default:
+                m_dropped++;
+                return;
+            }
+        }
+
+        m_buffer[(m_head + m_size) % capacity] = Item(args...);
+        m_size++;
+        if (m_size > m_high_water)
+        {
+            m_high_water = m_size;
+        }
+        m_not_empty.notify_one();
+    }
+
+    /**
+     * @brief Remove the oldest queued emit, the lock has to be held
+     */
+    void pop(void)
+    {
+        m_head = (uint16_t)((m_head + 1) % m_buffer.size());
+        m_size--;
+        m_not_full.notify_one();
+    }
+
+    /**
+     * @brief Move the oldest queued emit out of the buffer
+     * @param item Receives the emit
+     * @return true An emit was taken
+     * @return false Channel is empty
+     */
+    bool take(Item &item)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_size == 0)
+        {
+            return false;
+        }
+        item = std::move(m_buffer[m_head]);
+        pop();
+        return true;
+    }
+
+    template <size_t... Index>
+    static void call(const Slot<Type...> &slot, Item &item, ChannelIndices<Index...>)
+    {
+        slot(std::get<Index>(item)...);
+    }
+
+    template <size_t... Index>
+    static void emit(const Signal<Type...> &signal, Item &item, ChannelIndices<Index...>)
+    {
+        signal.emit(std::get<Index>(item)...);
+    }
+
+private:                                  /*Parameter*/
+    std::vector<Item> m_buffer;           /*!< Ring buffer of queued emits */
+    ChannelPolicy m_policy;               /*!< Behaviour when the buffer is full */
+    uint16_t m_head;                      /*!< Index of the oldest queued emit */
+    uint16_t m_size;                      /*!< Number of queued emits */
+    uint16_t m_high_water;                /*!< Highest number of queued emits */
+    uint32_t m_dropped;                   /*!< Number of dropped emits */
+    uint32_t m_coalesced;                 /*!< Number of coalesced emits */
+    bool m_closed;                        /*!< Channel does not accept emits anymore */
+    mutable std::mutex m_mutex;           /*!< Protects the buffer and the counters */
+    std::condition_variable m_not_empty;  /*!< Signalled when an emit was queued */
+    std::condition_variable m_not_full;   /*!< Signalled when room was made */
+};
+
+#endif // EVENTCHANNEL_H
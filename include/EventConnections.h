@@ -0,0 +1,477 @@
+#ifndef EVENTCONNECTIONS_H
+#define EVENTCONNECTIONS_H
+
+#include <stdint.h>
+#include <new>
+#include "Event_Config.h"
+
+#if (EVENT_USE_CPP_DEV_TYPE == EVENT_TYPE_STANDARD)
+#include <atomic>
+#endif
+
+/**
+ * @brief Header of the connection block of a signal
+ *
+ * A connected signal owns exactly one heap block: this header followed by m_capacity entry pointers. The connected
+ * slots are stored from the front of the entry array, the connected signals from the back, so both kinds share one
+ * allocation without storing a type tag per entry.
+ */
+struct alignas(void *) EventConnectionBlock
+{
+    static const uint8_t FLAG_TOMBSTONES = 0x01u; /*!< Entries were cleared during emit() */
+    static const uint8_t FLAG_ARENA = 0x02u;      /*!< Block is part of an EventConnectionArena */
+
+    uint16_t m_capacity;        /*!< Number of entries allocated behind the header */
+    uint16_t m_max_connections; /*!< Maximum number of connections of the signal */
+    uint16_t m_num_connections; /*!< Number of live connections */
+    uint16_t m_num_slots;       /*!< Used entries at the front, including cleared ones */
+    uint16_t m_num_signals;     /*!< Used entries at the back, including cleared ones */
+    uint8_t m_flags;            /*!< FLAG_TOMBSTONES, FLAG_ARENA */
+#if (EVENT_USE_CPP_DEV_TYPE == EVENT_TYPE_STANDARD)
+    std::atomic<uint8_t> m_emit_depth; /*!< Number of running emit() calls, nested or on other threads */
+#else
+    uint8_t m_emit_depth;              /*!< Nesting depth of running emit() calls */
+#endif
+
+    /**
+     * @brief Entry array behind the header
+     * @return void**
+     */
+    void **entries(void)
+    {
+        return reinterpret_cast<void **>(this + 1);
+    }
+};
+
+/**
+ * @brief Header of an arena holding the connection blocks of many signals
+ *
+ * An arena is allocated by EventWiring. Every block in it is preceded by a pointer back to the arena header. The arena
+ * counts its users, i.e. the signals whose current block lies in it plus the EventWiring which created it, and is
+ * freed by the last one, independent of the order in which the signals and the wiring are destroyed.
+ */
+struct alignas(void *) EventConnectionArena
+{
+    EventConnectionArena *m_next; /*!< Next arena of the same EventWiring */
+#if (EVENT_USE_CPP_DEV_TYPE == EVENT_TYPE_STANDARD)
+    std::atomic<uint32_t> m_users; /*!< Signals using a block of the arena, plus one for the EventWiring */
+#else
+    uint32_t m_users;              /*!< Signals using a block of the arena, plus one for the EventWiring */
+#endif
+
+    /**
+     * @brief Arena of a block with FLAG_ARENA
+     * @param block Block inside an arena
+     * @return EventConnectionArena*
+     */
+    static EventConnectionArena *of(EventConnectionBlock *block)
+    {
+        return reinterpret_cast<EventConnectionArena **>(block)[-1];
+    }
+
+    /**
+     * @brief Drop one user, the last one frees the arena
+     * @param arena Arena to release
+     */
+    static void release(EventConnectionArena *arena)
+    {
+#if (EVENT_USE_CPP_DEV_TYPE == EVENT_TYPE_STANDARD)
+        const bool last = (arena->m_users.fetch_sub(1, std::memory_order_acq_rel) == 1);
+#else
+        const bool last = (--arena->m_users == 0);
+#endif
+        if (last)
+        {
+            arena->~EventConnectionArena();
+            delete[] reinterpret_cast<uint8_t *>(arena);
+        }
+    }
+};
+
+/**
+ * @brief Connection storage of a signal
+ *
+ * The storage is a single word. A signal without connections stores its maximum number of connections in it, tagged
+ * with the lowest bit, and allocates nothing. The first connect replaces it with a pointer to an EventConnectionBlock.
+ * When the last connection is removed the block is freed again. Memory therefore scales with the connections made, not
+ * with the signals declared.
+ *
+ * The class has no virtual methods and is not templated; the typed emit loop lives in Signal.
+ *
+ * Thread safety on the standard backend: several threads may emit the same signal at the same time as long as nobody
+ * connects or disconnects it; the emit depth is atomic. Connecting and disconnecting reallocate, clear and compact the
+ * block without any synchronization with other threads. They are only allowed while no other thread emits the signal,
+ * and this includes slots: a slot may only connect or disconnect the signal which called it if that signal is emitted
+ * by a single thread. Use ShardedSignal for subscribers which change while other threads emit.
+ */
+class EventConnections
+{
+    friend class EventWiring;
+
+    static const uintptr_t EMPTY_TAG = 1u;
+
+protected:
+    /**
+     * @brief Construct a new empty connection storage
+     * @param max_connections Maximum number of connections
+     */
+    EventConnections(uint16_t max_connections) : m_state(emptyState(max_connections))
+    {
+    }
+
+    EventConnections(const EventConnections &) = delete;
+    EventConnections &operator=(const EventConnections &) = delete;
+
+    /**
+     * @brief Destroy the connection storage
+     */
+    ~EventConnections()
+    {
+        freeBlock(connectionBlock());
+        m_state = EMPTY_TAG;
+    }
+
+    /**
+     * @brief Current connection block
+     * @return EventConnectionBlock* nullptr if there are no connections
+     */
+    EventConnectionBlock *connectionBlock(void) const
+    {
+        return ((m_state & EMPTY_TAG) != 0) ? nullptr : reinterpret_cast<EventConnectionBlock *>(m_state);
+    }
+
+    /**
+     * @brief Maximum number of connections
+     * @return uint16_t
+     */
+    uint16_t maxConnections(void) const
+    {
+        EventConnectionBlock *block = connectionBlock();
+        return (block != nullptr) ? block->m_max_connections : (uint16_t)(m_state >> 1);
+    }
+
+    /**
+     * @brief Number of live connections
+     * @return uint16_t
+     */
+    uint16_t connectionCount(void) const
+    {
+        EventConnectionBlock *block = connectionBlock();
+        return (block != nullptr) ? block->m_num_connections : 0;
+    }
+
+    /**
+     * @brief Slot entry with the given index, read from the current block
+     * @param index Index of the slot in connection order
+     * @return void* nullptr if the slot was disconnected during emit()
+     */
+    void *slotEntry(uint16_t index) const
+    {
+        return connectionBlock()->entries()[index];
+    }
+
+    /**
+     * @brief Signal entry with the given index, read from the current block
+     * @param index Index of the signal in connection order
+     * @return void* nullptr if the signal was disconnected during emit()
+     */
+    void *signalEntry(uint16_t index) const
+    {
+        EventConnectionBlock *block = connectionBlock();
+        return block->entries()[block->m_capacity - 1u - index];
+    }
+
+    /**
+     * @brief Start an emit(), entries cleared until the matching endEmit() stay in place
+     * @param block Current connection block
+     */
+    static void beginEmit(EventConnectionBlock *block)
+    {
+#if (EVENT_USE_CPP_DEV_TYPE == EVENT_TYPE_STANDARD)
+        block->m_emit_depth.fetch_add(1, std::memory_order_acq_rel);
+#else
+        block->m_emit_depth++;
+#endif
+    }
+
+    /**
+     * @brief Finish an emit() started with beginEmit()
+     *
+     * Removes the entries cleared during the emit once the outermost emit() returns.
+     */
+    void endEmit(void) const
+    {
+        EventConnectionBlock *block = connectionBlock();
+
+#if (EVENT_USE_CPP_DEV_TYPE == EVENT_TYPE_STANDARD)
+        const bool outermost = (block->m_emit_depth.fetch_sub(1, std::memory_order_acq_rel) == 1);
+#else
+        const bool outermost = (--block->m_emit_depth == 0);
+#endif
+        if (outermost && ((block->m_flags & EventConnectionBlock::FLAG_TOMBSTONES) != 0))
+        {
+            const_cast<EventConnections *>(this)->compact();
+        }
+    }
+
+    /**
+     * @brief Add a connection
+     * @param entry Slot or signal to connect
+     * @param is_signal Entry is a signal
+     * @param exact_growth Grow the block by one entry instead of doubling it
+     * @return true Connection was added
+     * @return false Maximum number of connections reached
+     *
+     * The block may move while an emit is running; the emit loop reads the entries through slotEntry() /
+     * signalEntry() and therefore always sees the current block.
+     */
+    bool connectEntry(void *entry, bool is_signal, bool exact_growth)
+    {
+        EventConnectionBlock *block = connectionBlock();
+        const uint16_t max_connections = maxConnections();
+
+        if (((block != nullptr) && (block->m_num_connections >= max_connections)) || (max_connections == 0))
+        {
+            return false;
+        }
+
+        if ((block == nullptr) || (block->m_num_slots + block->m_num_signals == block->m_capacity))
+        {
+            uint32_t capacity = (block == nullptr) ? 0u : block->m_capacity;
+            uint32_t limit = max_connections;
+
+            if (block != nullptr)
+            {
+                /* Entries cleared during a running emit still occupy the block until the emit returned */
+                limit += (uint32_t)block->m_num_slots + block->m_num_signals - block->m_num_connections;
+            }
+            if (limit > UINT16_MAX)
+            {
+                limit = UINT16_MAX;
+            }
+
+            capacity = exact_growth ? (capacity + 1u) : ((capacity == 0u) ? 2u : (capacity * 2u));
+            if (capacity > limit)
+            {
+                capacity = limit;
+            }
+            if ((block != nullptr) && (capacity <= block->m_capacity))
+            {
+                return false;
+            }
+            block = resize((uint16_t)capacity, max_connections);
+        }
+
+        if (is_signal)
+        {
+            block->entries()[block->m_capacity - 1u - block->m_num_signals] = entry;
+            block->m_num_signals++;
+        }
+        else
+        {
+            block->entries()[block->m_num_slots] = entry;
+            block->m_num_slots++;
+        }
+        block->m_num_connections++;
+        return true;
+    }
+
+    /**
+     * @brief Remove a connection
+     * @param entry Slot or signal to disconnect
+     * @param is_signal Entry is a signal
+     * @return true Connection was removed
+     * @return false Entry was not connected
+     *
+     * While an emit is running the entry is only cleared and removed after the outermost emit() returned.
+     */
+    bool disconnectEntry(const void *entry, bool is_signal)
+    {
+        EventConnectionBlock *block = connectionBlock();
+
+        if (block == nullptr)
+        {
+            return false;
+        }
+
+        void **entries = block->entries();
+        const uint16_t count = is_signal ? block->m_num_signals : block->m_num_slots;
+
+        for (uint16_t i = 0; i < count; i++)
+        {
+            const uint16_t index = is_signal ? (uint16_t)(block->m_capacity - 1u - i) : i;
+            if (entries[index] == entry)
+            {
+                entries[index] = nullptr;
+                block->m_num_connections--;
+                block->m_flags |= EventConnectionBlock::FLAG_TOMBSTONES;
+                if (block->m_emit_depth == 0)
+                {
+                    compact();
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+private: /* Methods */
+    /**
+     * @brief Encode an empty storage
+     * @param max_connections Maximum number of connections
+     * @return uintptr_t
+     */
+    static uintptr_t emptyState(uint16_t max_connections)
+    {
+        uintptr_t max_value = max_connections;
+        if (max_value > (UINTPTR_MAX >> 1))
+        {
+            /* 16 bit pointers, more connections do not fit into RAM anyway */
+            max_value = (UINTPTR_MAX >> 1);
+        }
+        return (max_value << 1) | EMPTY_TAG;
+    }
+
+    /**
+     * @brief Move the connections into a block of a new size
+     * @param capacity Number of entries of the new block
+     * @param max_connections Maximum number of connections
+     * @return EventConnectionBlock* New block, already installed
+     */
+    EventConnectionBlock *resize(uint16_t capacity, uint16_t max_connections)
+    {
+        return install(new uint8_t[blockSize(capacity)], capacity, max_connections, 0);
+    }
+
+    /**
+     * @brief Size of a connection block in bytes
+     * @param capacity Number of entries
+     * @return uint32_t
+     */
+    static uint32_t blockSize(uint16_t capacity)
+    {
+        return sizeof(EventConnectionBlock) + (uint32_t)capacity * sizeof(void *);
+    }
+
+    /**
+     * @brief Move the connections into a new block and make it the current block
+     * @param memory Memory of blockSize(capacity) bytes, aligned for a pointer
+     * @param capacity Number of entries of the new block
+     * @param max_connections Maximum number of connections
+     * @param owner_flags FLAG_ARENA if the memory is part of an EventConnectionArena which counts the signal as user
+     * @return EventConnectionBlock* New block
+     */
+    EventConnectionBlock *install(uint8_t *memory, uint16_t capacity, uint16_t max_connections, uint8_t owner_flags)
+    {
+        EventConnectionBlock *old_block = connectionBlock();
+        EventConnectionBlock *block = new (memory) EventConnectionBlock();
+
+        block->m_capacity = capacity;
+        block->m_max_connections = max_connections;
+        if (old_block == nullptr)
+        {
+            block->m_num_connections = 0;
+            block->m_num_slots = 0;
+            block->m_num_signals = 0;
+            block->m_emit_depth = 0;
+            block->m_flags = owner_flags;
+        }
+        else
+        {
+            void **entries = block->entries();
+            void **old_entries = old_block->entries();
+
+            /* Keeps counters, emit depth and flags of a running emit */
+            block->m_num_connections = old_block->m_num_connections;
+            block->m_num_slots = old_block->m_num_slots;
+            block->m_num_signals = old_block->m_num_signals;
+            block->m_emit_depth = (uint8_t)old_block->m_emit_depth;
+            block->m_flags = (uint8_t)((old_block->m_flags & ~EventConnectionBlock::FLAG_ARENA) | owner_flags);
+            for (uint16_t i = 0; i < old_block->m_num_slots; i++)
+            {
+                entries[i] = old_entries[i];
+            }
+            for (uint16_t i = 0; i < old_block->m_num_signals; i++)
+            {
+                entries[capacity - 1u - i] = old_entries[old_block->m_capacity - 1u - i];
+            }
+            freeBlock(old_block);
+        }
+
+        m_state = reinterpret_cast<uintptr_t>(block);
+        return block;
+    }
+
+    /**
+     * @brief Remove the cleared entries, frees the block if no connection is left
+     */
+    void compact(void)
+    {
+        EventConnectionBlock *block = connectionBlock();
+        void **entries = block->entries();
+        uint16_t used = 0;
+
+        if (block->m_num_connections == 0)
+        {
+            const uint16_t max_connections = block->m_max_connections;
+            freeBlock(block);
+            m_state = emptyState(max_connections);
+            return;
+        }
+
+        for (uint16_t i = 0; i < block->m_num_slots; i++)
+        {
+            if (entries[i] != nullptr)
+            {
+                entries[used++] = entries[i];
+            }
+        }
+        block->m_num_slots = used;
+
+        used = 0;
+        for (uint16_t i = 0; i < block->m_num_signals; i++)
+        {
+            void *entry = entries[block->m_capacity - 1u - i];
+            if (entry != nullptr)
+            {
+                entries[block->m_capacity - 1u - used++] = entry;
+            }
+        }
+        block->m_num_signals = used;
+        block->m_flags &= (uint8_t)~EventConnectionBlock::FLAG_TOMBSTONES;
+
+        if (block->m_capacity > block->m_max_connections)
+        {
+            /* Grown beyond the maximum for connects during an emit, give the extra entries back */
+            resize(block->m_max_connections, block->m_max_connections);
+        }
+    }
+
+    /**
+     * @brief Free a connection block
+     * @param block Block to free, may be nullptr
+     *
+     * A block of an arena only drops the signal as user of the arena.
+     */
+    static void freeBlock(EventConnectionBlock *block)
+    {
+        if (block == nullptr)
+        {
+            return;
+        }
+
+        if ((block->m_flags & EventConnectionBlock::FLAG_ARENA) != 0)
+        {
+            EventConnectionArena::release(EventConnectionArena::of(block));
+        }
+        else
+        {
+            delete[] reinterpret_cast<uint8_t *>(block);
+        }
+    }
+
+private:            /*Parameter*/
+    uintptr_t m_state; /*!< Tagged maximum number of connections or pointer to the EventConnectionBlock */
+};
+
+#endif // EVENTCONNECTIONS_H
@@ -0,0 +1,386 @@
+#ifndef EVENTPAYLOAD_H
+#define EVENTPAYLOAD_H
+
+#include <stdint.h>
+#include <string.h>
+#include <new>
+#include "Event_Config.h"
+
+#if (EVENT_USE_CPP_DEV_TYPE == EVENT_TYPE_STANDARD)
+#include <atomic>
+#include <mutex>
+#endif
+
+class EventPayloadPool;
+
+/**
+ * @brief Header of one pool buffer, the payload bytes follow behind it
+ */
+struct alignas(void *) EventPayloadBuffer
+{
+#if (EVENT_USE_CPP_DEV_TYPE == EVENT_TYPE_STANDARD)
+    std::atomic<uint32_t> m_references; /*!< Number of EventPayload handles sharing the buffer */
+#else
+    uint32_t m_references;              /*!< Number of EventPayload handles sharing the buffer */
+#endif
+    uint16_t m_size;                    /*!< Number of used payload bytes */
+    EventPayloadPool *m_pool;           /*!< Pool the buffer is returned to */
+    EventPayloadBuffer *m_next;         /*!< Next buffer in the free list of the pool */
+
+    /**
+     * @brief Payload bytes behind the header
+     * @return uint8_t*
+     */
+    uint8_t *bytes(void)
+    {
+        return reinterpret_cast<uint8_t *>(this + 1);
+    }
+};
+
+/**
+ * @brief Shared, immutable payload for signals
+ *
+ * EventPayload is a handle to a buffer of an EventPayloadPool. Copying the handle only increments a reference counter,
+ * so a Signal<EventPayload> hands the same buffer to every slot, and slots which process the data later (queued in an
+ * EventChannel, delayed by an EventTimerWheel or stored by the receiver) simply keep their copy of the handle. The
+ * buffer goes back to the pool when the last handle is released. Neither the emit nor the receivers copy the data or
+ * allocate memory.
+ *
+ * The data may only be written through mutableData() while the handle is the only one, i.e. before it is emitted.
+ * Signals declared with const EventPayload & avoid even the reference counting for slots which do not keep the payload.
+ *
+ * On the embedded backend the reference counter is not interrupt safe; payloads must not be shared between an
+ * interrupt and loop().
+ */
+class EventPayload
+{
+    friend class EventPayloadPool;
+
+public:
+    /**
+     * @brief Construct an empty payload
+     */
+    EventPayload() : m_buffer(nullptr)
+    {
+    }
+
+    /**
+     * @brief Share the buffer of another payload
+     * @param other Payload to share
+     */
+    EventPayload(const EventPayload &other) : m_buffer(other.m_buffer)
+    {
+        retain();
+    }
+
+    /**
+     * @brief Take over the buffer of another payload
+     * @param other Payload to take over, empty afterwards
+     */
+    EventPayload(EventPayload &&other) : m_buffer(other.m_buffer)
+    {
+        other.m_buffer = nullptr;
+    }
+
+    /**
+     * @brief Destroy the payload handle
+     */
+    ~EventPayload()
+    {
+        reset();
+    }
+
+    EventPayload &operator=(const EventPayload &other)
+    {
+        if (m_buffer != other.m_buffer)
+        {
+            reset();
+            m_buffer = other.m_buffer;
+            retain();
+        }
+        return *this;
+    }
+
+    EventPayload &operator=(EventPayload &&other)
+    {
+        if (this != &other)
+        {
+            reset();
+            m_buffer = other.m_buffer;
+            other.m_buffer = nullptr;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Check if the payload refers to a buffer
+     * @return true
+     * @return false Empty payload or the pool was exhausted
+     */
+    bool valid(void) const
+    {
+        return m_buffer != nullptr;
+    }
+
+    /**
+     * @brief Payload data
+     * @return const uint8_t* nullptr for an empty payload
+     */
+    const uint8_t *data(void) const
+    {
+        return (m_buffer != nullptr) ? m_buffer->bytes() : nullptr;
+    }
+
+    /**
+     * @brief Writable payload data
+     * @return uint8_t* nullptr if the buffer is already shared
+     */
+    uint8_t *mutableData(void)
+    {
+        return unique() ? m_buffer->bytes() : nullptr;
+    }
+
+    /**
+     * @brief Number of used payload bytes
+     * @return uint16_t
+     */
+    uint16_t size(void) const
+    {
+        return (m_buffer != nullptr) ? m_buffer->m_size : 0;
+    }
+
+    /**
+     * @brief Change the number of used payload bytes
+     * @param size New size, at most the buffer size of the pool
+     * @return true
+     * @return false Buffer is shared or too small
+     */
+    bool resize(uint16_t size);
+
+    /**
+     * @brief Check if this handle is the only one of its buffer
+     * @return true
+     * @return false
+     */
+    bool unique(void) const
+    {
+        return useCount() == 1;
+    }
+
+    /**
+     * @brief Number of handles sharing the buffer
+     * @return uint32_t
+     */
+    uint32_t useCount(void) const
+    {
+        if (m_buffer == nullptr)
+        {
+            return 0;
+        }
+#if (EVENT_USE_CPP_DEV_TYPE == EVENT_TYPE_STANDARD)
+        return m_buffer->m_references.load(std::memory_order_acquire);
+#else
+        return m_buffer->m_references;
+#endif
+    }
+
+    /**
+     * @brief Release the buffer, the payload is empty afterwards
+     */
+    void reset(void);
+
+private: /* Methods */
+    /**
+     * @brief Construct a payload owning a freshly acquired buffer
+     * @param buffer Buffer with a reference count of one
+     */
+    explicit EventPayload(EventPayloadBuffer *buffer) : m_buffer(buffer)
+    {
+    }
+
+    void retain(void)
+    {
+        if (m_buffer != nullptr)
+        {
+#if (EVENT_USE_CPP_DEV_TYPE == EVENT_TYPE_STANDARD)
+            m_buffer->m_references.fetch_add(1, std::memory_order_relaxed);
+#else
+            m_buffer->m_references++;
+#endif
+        }
+    }
+
+private:                          /*Parameter*/
+    EventPayloadBuffer *m_buffer; /*!< Shared pool buffer, nullptr for an empty payload */
+};
+
+/**
+ * @brief Preallocated pool of payload buffers
+ *
+ * All buffers are allocated with the pool in one block; acquire() takes a buffer from the free list and never allocates.
+ * The pool has to outlive all payloads taken from it.
+ */
+class EventPayloadPool
+{
+    friend class EventPayload;
+
+public:
+    /**
+     * @brief Construct a new Payload Pool object
+     * @param buffer_size Maximum payload size in bytes
+     * @param num_buffers Number of buffers
+     */
+    EventPayloadPool(uint16_t buffer_size, uint16_t num_buffers) : m_buffer_size(buffer_size),
+                                                                   m_num_buffers(num_buffers),
+                                                                   m_available(num_buffers),
+                                                                   m_free(nullptr)
+    {
+        const uint32_t align = alignof(EventPayloadBuffer);
+        m_stride = sizeof(EventPayloadBuffer) + (((uint32_t)buffer_size + align - 1u) / align) * align;
+        m_memory = new uint8_t[m_stride * num_buffers];
+
+        for (uint16_t i = num_buffers; i > 0; i--)
+        {
+            EventPayloadBuffer *buffer = new (m_memory + (uint32_t)(i - 1u) * m_stride) EventPayloadBuffer();
+            buffer->m_references = 0;
+            buffer->m_size = 0;
+            buffer->m_pool = this;
+            buffer->m_next = m_free;
+            m_free = buffer;
+        }
+    }
+
+    EventPayloadPool(const EventPayloadPool &) = delete;
+    EventPayloadPool &operator=(const EventPayloadPool &) = delete;
+
+    /**
+     * @brief Destroy the Payload Pool object
+     */
+    ~EventPayloadPool()
+    {
+        for (uint16_t i = 0; i < m_num_buffers; i++)
+        {
+            reinterpret_cast<EventPayloadBuffer *>(m_memory + (uint32_t)i * m_stride)->~EventPayloadBuffer();
+        }
+        delete[] m_memory;
+    }
+
+    /**
+     * @brief Take a buffer from the pool
+     * @param size Number of payload bytes
+     * @return EventPayload Empty payload if the pool is exhausted or size exceeds the buffer size
+     */
+    EventPayload acquire(uint16_t size)
+    {
+        EventPayloadBuffer *buffer = nullptr;
+
+        if (size <= m_buffer_size)
+        {
+#if (EVENT_USE_CPP_DEV_TYPE == EVENT_TYPE_STANDARD)
+            std::lock_guard<std::mutex> lock(m_mutex);
+#endif
+            buffer = m_free;
+            if (buffer != nullptr)
+            {
+                m_free = buffer->m_next;
+                m_available--;
+                buffer->m_next = nullptr;
+                buffer->m_size = size;
+                buffer->m_references = 1;
+            }
+        }
+        return EventPayload(buffer);
+    }
+
+    /**
+     * @brief Take a buffer from the pool and copy data into it
+     * @param data Data to copy
+     * @param size Number of bytes
+     * @return EventPayload Empty payload if the pool is exhausted or size exceeds the buffer size
+     */
+    EventPayload acquire(const void *data, uint16_t size)
+    {
+        EventPayload payload = acquire(size);
+        if (payload.valid())
+        {
+            memcpy(payload.mutableData(), data, size);
+        }
+        return payload;
+    }
+
+    /**
+     * @brief Number of free buffers
+     * @return uint16_t
+     */
+    uint16_t available(void) const
+    {
+#if (EVENT_USE_CPP_DEV_TYPE == EVENT_TYPE_STANDARD)
+        std::lock_guard<std::mutex> lock(m_mutex);
+#endif
+        return m_available;
+    }
+
+    /**
+     * @brief Maximum payload size in bytes
+     * @return uint16_t
+     */
+    uint16_t bufferSize(void) const
+    {
+        return m_buffer_size;
+    }
+
+private: /* Methods */
+    /**
+     * @brief Return a buffer to the free list
+     * @param buffer Buffer without references
+     */
+    void release(EventPayloadBuffer *buffer)
+    {
+#if (EVENT_USE_CPP_DEV_TYPE == EVENT_TYPE_STANDARD)
+        std::lock_guard<std::mutex> lock(m_mutex);
+#endif
+        buffer->m_next = m_free;
+        m_free = buffer;
+        m_available++;
+    }
+
+private:                       /*Parameter*/
+    uint16_t m_buffer_size;    /*!< Maximum payload size */
+    uint16_t m_num_buffers;    /*!< Number of buffers */
+    uint16_t m_available;      /*!< Number of free buffers */
+    uint32_t m_stride;         /*!< Distance between two buffers in bytes */
+    uint8_t *m_memory;         /*!< Memory of all buffers */
+    EventPayloadBuffer *m_free; /*!< Free list */
+#if (EVENT_USE_CPP_DEV_TYPE == EVENT_TYPE_STANDARD)
+    mutable std::mutex m_mutex; /*!< Protects the free list */
+#endif
+};
+
+inline bool EventPayload::resize(uint16_t size)
+{
+    if (unique() && (size <= m_buffer->m_pool->bufferSize()))
+    {
+        m_buffer->m_size = size;
+        return true;
+    }
+    return false;
+}
+
+inline void EventPayload::reset(void)
+{
+    if (m_buffer != nullptr)
+    {
+#if (EVENT_USE_CPP_DEV_TYPE == EVENT_TYPE_STANDARD)
+        const bool last = (m_buffer->m_references.fetch_sub(1, std::memory_order_acq_rel) == 1);
+#else
+        const bool last = (--m_buffer->m_references == 0);
+#endif
+        if (last)
+        {
+            m_buffer->m_pool->release(m_buffer);
+        }
+        m_buffer = nullptr;
+    }
+}
+
+#endif // EVENTPAYLOAD_H
@@ -0,0 +1,566 @@
+#ifndef EVENTSHARDEDSIGNAL_H
+#define EVENTSHARDEDSIGNAL_H
+
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <thread>
+#include "Event_Config.h"
+#include "EventSlot.h"
+
+/**
+ * @brief Forward decleartion of the clas Signal
+ */
+template <class... Type> class Signal;
+
+/**
+ * @brief Per-thread state shared by all ShardedSignal types
+ */
+struct ShardedSignalThread
+{
+    /**
+     * @brief Number of ShardedSignal emits running on the calling thread
+     * @return uint32_t&
+     */
+    static uint32_t &emitDepth(void)
+    {
+        static thread_local uint32_t depth = 0;
+        return depth;
+    }
+
+    /**
+     * @brief Sequence number of the calling thread, assigned on first use
+     * @return uint32_t
+     */
+    static uint32_t index(void)
+    {
+        static std::atomic<uint32_t> thread_count(0);
+        static thread_local uint32_t index = thread_count.fetch_add(1, std::memory_order_relaxed);
+        return index;
+    }
+};
+
+/**
+ * @brief Signal with per-thread subscriber shards
+ * @tparam Type
+ *
+ * A plain Signal shared by many threads is one cache line which every emitter reads and every connect writes. The
+ * ShardedSignal splits its subscribers into shards, each on its own cache lines. Every thread is bound to one shard:
+ * connect() without shard index registers the subscriber on the shard of the calling thread, emitLocal() delivers only
+ * to the shard of the calling thread, and emit() delivers to the local shard first and then to all other shards.
+ *
+ * Emitting takes no lock. The subscribers of a shard are an immutable snapshot which connect() / disconnect() replace
+ * under the lock of the shard and publish with one atomic store. An emitter only writes the reader counter of its own
+ * shard and reads the snapshots of the others, so emitters on different shards never write a shared cache line.
+ *
+ * disconnect() waits until all emits which may still call the removed subscriber have returned, so the slot can be
+ * destroyed afterwards. Called from inside a slot it cannot wait for its own emit; the removed subscriber is then
+ * skipped by new emits only, and the slot must stay alive until the emits running on other threads returned. The
+wait holds no lock of a shard, so the running slots may connect and disconnect meanwhile.
+ *
+ * Slots are executed on the emitting thread. A slot may connect, disconnect or emit on the same ShardedSignal. Threads
+ * are bound to shards in the order in which they first use any ShardedSignal.
+ */
+template <class... Type>
+class ShardedSignal
+{
+    /**
+     * @brief Immutable subscriber list of a shard, the slot entries are followed by the signal entries
+     */
+    struct alignas(void *) Snapshot
+    {
+        Snapshot *m_retired;    /*!< Next replaced snapshot waiting to be freed */
+        uint16_t m_num_slots;   /*!< Number of slot entries */
+        uint16_t m_num_signals; /*!< Number of signal entries */
+
+        /**
+         * @brief Entry array behind the header
+         * @return void**
+         */
+        void **entries(void)
+        {
+            return reinterpret_cast<void **>(this + 1);
+        }
+    };
+
+    /**
+     * @brief Subscribers of one shard, padded to whole cache lines
+     *
+     * The reader counters are written by every emit of the threads bound to the shard and therefore sit on their own
+     * cache line, away from the snapshot pointer which all emitters read.
+     */
+    struct alignas(EVENT_CACHE_LINE_SIZE) Shard
+    {
+        Shard() : m_snapshot(nullptr), m_connections(0), m_retired(nullptr)
+        {
+            m_readers[0] = 0;
+            m_readers[1] = 0;
+        }
+
+        std::atomic<Snapshot *> m_snapshot;  /*!< Current subscribers, nullptr if there are none */
+        std::atomic<uint16_t> m_connections; /*!< Number of subscribers */
+        std::mutex m_mutex;                  /*!< Serializes connect() / disconnect() on the shard */
+        Snapshot *m_retired;                 /*!< Replaced snapshots which may still be read by an emit */
+        alignas(EVENT_CACHE_LINE_SIZE) std::atomic<uint32_t> m_readers[2]; /*!< Running emits of the shard's threads per epoch */
+    };
+
+public:
+    /**
+     * @brief Construct a new Sharded Signal object
+     * @param num_shards Number of shards, 0 for one shard per hardware thread
+     */
+    ShardedSignal(uint16_t num_shards = 0) : m_num_shards(num_shards),
+                                             m_epoch(0)
+    {
+        if (m_num_shards == 0)
+        {
+            unsigned hardware_threads = std::thread::hardware_concurrency();
+            m_num_shards = (uint16_t)((hardware_threads == 0) ? 1u : ((hardware_threads > UINT16_MAX) ? UINT16_MAX : hardware_threads));
+        }
+
+        /* Shards are over aligned, place them manually in a raw buffer */
+        m_memory = new uint8_t[(m_num_shards + 1u) * sizeof(Shard)];
+        uintptr_t address = reinterpret_cast<uintptr_t>(m_memory);
+        address = (address + EVENT_CACHE_LINE_SIZE - 1u) & ~(uintptr_t)(EVENT_CACHE_LINE_SIZE - 1u);
+        m_shards = reinterpret_cast<Shard *>(address);
+
+        for (uint16_t i = 0; i < m_num_shards; i++)
+        {
+            new (&m_shards[i]) Shard();
+        }
+    }
+
+    ShardedSignal(const ShardedSignal &) = delete;
+    ShardedSignal &operator=(const ShardedSignal &) = delete;
+
+    /**
+     * @brief Destroy the Sharded Signal object
+     *
+     * No emit may be running any more.
+     */
+    ~ShardedSignal()
+    {
+        for (uint16_t i = 0; i < m_num_shards; i++)
+        {
+            freeSnapshot(m_shards[i].m_snapshot.load(std::memory_order_relaxed));
+            freeRetired(m_shards[i].m_retired);
+            m_shards[i].~Shard();
+        }
+        delete[] m_memory;
+    }
+
+    /**
+     * @brief Connect a slot to the shard of the calling thread
+     * @param[in] slot Slot to connect
+     */
+    void connect(const Slot<Type...> &slot)
+    {
+        connect(slot, localShard());
+    }
+
+    /**
+     * @brief Connect a slot to a given shard
+     * @param[in] slot Slot to connect
+     * @param[in] shard Index of the shard
+     */
+    void connect(const Slot<Type...> &slot, uint16_t shard)
+    {
+        add(m_shards[shard % m_num_shards], const_cast<Slot<Type...> *>(&slot), false);
+    }
+
+    /**
+     * @brief Connect a signal to the shard of the calling thread
+     * @param[in] signal Signal to connect
+     */
+    void connect(const Signal<Type...> &signal)
+    {
+        connect(signal, localShard());
+    }
+
+    /**
+     * @brief Connect a signal to a given shard
+     * @param[in] signal Signal to connect
+     * @param[in] shard Index of the shard
+     */
+    void connect(const Signal<Type...> &signal, uint16_t shard)
+    {
+        add(m_shards[shard % m_num_shards], const_cast<Signal<Type...> *>(&signal), true);
+    }
+
+    /**
+     * @brief Disconnect a slot, the local shard is searched first
+     * @param[in] slot Slot to disconnect
+     */
+    void disconnect(const Slot<Type...> &slot)
+    {
+        const uint16_t local = localShard();
+
+        for (uint16_t i = 0; i < m_num_shards; i++)
+        {
+            if (remove(m_shards[(local + i) % m_num_shards], &slot, false))
+            {
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Disconnect a signal, the local shard is searched first
+     * @param[in] signal Signal to disconnect
+     */
+    void disconnect(const Signal<Type...> &signal)
+    {
+        const uint16_t local = localShard();
+
+        for (uint16_t i = 0; i < m_num_shards; i++)
+        {
+            if (remove(m_shards[(local + i) % m_num_shards], &signal, true))
+            {
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Emit to all shards, starting with the shard of the calling thread
+     * @param args Parameter
+     */
+    void emit(Type... args) const
+    {
+        emitShards(m_num_shards, args...);
+    }
+
+    /**
+     * @brief Emit only to the subscribers of the calling thread's shard
+     * @param args Parameter
+     */
+    void emitLocal(Type... args) const
+    {
+        emitShards(1, args...);
+    }
+
+    /**
+     * @brief Number of connections over all shards
+     * @return uint32_t
+     */
+    uint32_t connections(void) const
+    {
+        uint32_t connections = 0;
+        for (uint16_t i = 0; i < m_num_shards; i++)
+        {
+            connections += m_shards[i].m_connections.load(std::memory_order_relaxed);
+        }
+        return connections;
+    }
+
+    /**
+     * @brief Number of shards
+     * @return uint16_t
+     */
+    uint16_t shards(void) const
+    {
+        return m_num_shards;
+    }
+
+    /**
+     * @brief Shard of the calling thread
+     * @return uint16_t
+     */
+    uint16_t localShard(void) const
+    {
+        return (uint16_t)(threadIndex() % m_num_shards);
+    }
+
+private: /* Methods */
+    /**
+     * @brief Emit the snapshots of the first shards, starting with the local one
+     * @param count Number of shards to emit
+     * @param args Parameter
+     *
+     * The reader counter of the local shard is raised before the snapshot pointers are read, so a connect() /
+     * disconnect() which replaced one of them afterwards sees the running emit and keeps the old snapshot.
+     */
+    void emitShards(uint16_t count, Type... args) const
+    {
+        const uint16_t local = localShard();
+        std::atomic<uint32_t> &readers = m_shards[local].m_readers[m_epoch.load(std::memory_order_seq_cst) & 1u];
+
+        readers.fetch_add(1, std::memory_order_seq_cst);
+        emitDepth()++;
+        for (uint16_t i = 0; i < count; i++)
+        {
+            Snapshot *snapshot = m_shards[(local + i) % m_num_shards].m_snapshot.load(std::memory_order_seq_cst);
+            if (snapshot != nullptr)
+            {
+                emitSnapshot(snapshot, args...);
+            }
+        }
+        emitDepth()--;
+        readers.fetch_sub(1, std::memory_order_seq_cst);
+    }
+
+    /**
+     * @brief Call all subscribers of a snapshot
+     * @param snapshot Snapshot to emit
+     * @param args Parameter
+     */
+    static void emitSnapshot(Snapshot *snapshot, Type... args)
+    {
+        void **entries = snapshot->entries();
+        const uint16_t num_slots = snapshot->m_num_slots;
+        const uint16_t num_entries = num_slots + snapshot->m_num_signals;
+
+        for (uint16_t i = 0; i < num_slots; i++)
+        {
+            (*static_cast<Slot<Type...> *>(entries[i]))(args...);
+        }
+        for (uint16_t i = num_slots; i < num_entries; i++)
+        {
+            static_cast<Signal<Type...> *>(entries[i])->emit(args...);
+        }
+    }
+
+    /**
+     * @brief Publish a snapshot with one more entry
+     * @param shard Shard to modify
+     * @param entry Slot or signal to add
+     * @param is_signal Entry is a signal
+     */
+    void add(Shard &shard, void *entry, bool is_signal)
+    {
+        std::lock_guard<std::mutex> lock(shard.m_mutex);
+        Snapshot *current = shard.m_snapshot.load(std::memory_order_relaxed);
+        const uint16_t num_slots = (current != nullptr) ? current->m_num_slots : 0;
+        const uint16_t num_signals = (current != nullptr) ? current->m_num_signals : 0;
+
+        if ((uint32_t)num_slots + num_signals >= UINT16_MAX)
+        {
+            return;
+        }
+
+        Snapshot *snapshot = allocSnapshot(is_signal ? num_slots : (uint16_t)(num_slots + 1u),
+                                           is_signal ? (uint16_t)(num_signals + 1u) : num_signals);
+        void **entries = snapshot->entries();
+        uint16_t used = 0;
+
+        for (uint16_t i = 0; i < num_slots; i++)
+        {
+            entries[used++] = current->entries()[i];
+        }
+        if (!is_signal)
+        {
+            entries[used++] = entry;
+        }
+        for (uint16_t i = 0; i < num_signals; i++)
+        {
+            entries[used++] = current->entries()[num_slots + i];
+        }
+        if (is_signal)
+        {
+            entries[used++] = entry;
+        }
+        publish(shard, snapshot, used);
+
+        if ((emitDepth() == 0) && !emitting())
+        {
+            freeRetired(shard.m_retired);
+            shard.m_retired = nullptr;
+        }
+    }
+
+    /**
+     * @brief Publish a snapshot without an entry
+     * @param shard Shard to modify
+     * @param entry Slot or signal to remove
+     * @param is_signal Entry is a signal
+     * @return true Entry was part of the shard and is removed
+     * @return false Entry is not connected to the shard
+     */
+    bool remove(Shard &shard, const void *entry, bool is_signal)
+    {
+        std::unique_lock<std::mutex> lock(shard.m_mutex);
+        Snapshot *current = shard.m_snapshot.load(std::memory_order_relaxed);
+
+        if (current == nullptr)
+        {
+            return false;
+        }
+
+        const uint16_t num_slots = current->m_num_slots;
+        const uint16_t num_signals = current->m_num_signals;
+        const uint16_t first = is_signal ? num_slots : 0;
+        const uint16_t last = is_signal ? (uint16_t)(num_slots + num_signals) : num_slots;
+        uint16_t index = first;
+
+        while ((index < last) && (current->entries()[index] != entry))
+        {
+            index++;
+        }
+        if (index == last)
+        {
+            return false;
+        }
+
+        const uint16_t used = (uint16_t)(num_slots + num_signals - 1u);
+        Snapshot *snapshot = nullptr;
+
+        if (used != 0)
+        {
+            snapshot = allocSnapshot(is_signal ? num_slots : (uint16_t)(num_slots - 1u),
+                                     is_signal ? (uint16_t)(num_signals - 1u) : num_signals);
+            for (uint16_t i = 0, j = 0; i <= used; i++)
+            {
+                if (i != index)
+                {
+                    snapshot->entries()[j++] = current->entries()[i];
+                }
+            }
+        }
+        publish(shard, snapshot, used);
+
+        if (emitDepth() != 0)
+        {
+            /* Inside a slot: waiting would wait for the own emit, a later call frees the snapshots */
+            return true;
+        }
+
+        /* Wait without the lock of the shard, a running slot may connect or disconnect on it meanwhile */
+        Snapshot *retired = shard.m_retired;
+        shard.m_retired = nullptr;
+        lock.unlock();
+        synchronize();
+        freeRetired(retired);
+        return true;
+    }
+
+    /**
+     * @brief Replace the snapshot of a shard, called with the lock of the shard held
+     * @param shard Shard to modify
+     * @param snapshot New snapshot, nullptr if the shard has no subscribers
+     * @param connections Number of subscribers in the new snapshot
+     *
+     * The old snapshot is kept in the retired list until no emit can use it any more, since an emit may have read it
+     * before the exchange.
+     */
+    void publish(Shard &shard, Snapshot *snapshot, uint16_t connections)
+    {
+        Snapshot *old = shard.m_snapshot.exchange(snapshot, std::memory_order_seq_cst);
+
+        shard.m_connections.store(connections, std::memory_order_relaxed);
+        if (old != nullptr)
+        {
+            old->m_retired = shard.m_retired;
+            shard.m_retired = old;
+        }
+    }
+
+    /**
+     * @brief Wait until all emits which were running when the call started have returned
+     *
+     * Emits count themselves in the reader counter of the current epoch. The epoch is switched twice and the counters
+     * of the previous epoch are drained each time, so new emits never delay the wait.
+     */
+    void synchronize(void)
+    {
+        std::lock_guard<std::mutex> lock(m_sync_mutex);
+
+        for (uint16_t phase = 0; phase < 2u; phase++)
+        {
+            const uint32_t epoch = m_epoch.fetch_add(1, std::memory_order_seq_cst) & 1u;
+
+            for (uint16_t i = 0; i < m_num_shards; i++)
+            {
+                while (m_shards[i].m_readers[epoch].load(std::memory_order_seq_cst) != 0)
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Check if an emit is running on any thread
+     * @return true
+     * @return false
+     */
+    bool emitting(void) const
+    {
+        for (uint16_t i = 0; i < m_num_shards; i++)
+        {
+            if ((m_shards[i].m_readers[0].load(std::memory_order_seq_cst) != 0) ||
+                (m_shards[i].m_readers[1].load(std::memory_order_seq_cst) != 0))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Allocate a snapshot
+     * @param num_slots Number of slot entries
+     * @param num_signals Number of signal entries
+     * @return Snapshot*
+     */
+    static Snapshot *allocSnapshot(uint16_t num_slots, uint16_t num_signals)
+    {
+        uint8_t *memory = new uint8_t[sizeof(Snapshot) + ((uint32_t)num_slots + num_signals) * sizeof(void *)];
+        Snapshot *snapshot = new (memory) Snapshot();
+
+        snapshot->m_retired = nullptr;
+        snapshot->m_num_slots = num_slots;
+        snapshot->m_num_signals = num_signals;
+        return snapshot;
+    }
+
+    /**
+     * @brief Free a snapshot
+     * @param snapshot Snapshot to free, may be nullptr
+     */
+    static void freeSnapshot(Snapshot *snapshot)
+    {
+        delete[] reinterpret_cast<uint8_t *>(snapshot);
+    }
+
+    /**
+     * @brief Free a list of replaced snapshots
+     * @param retired First snapshot of the list, may be nullptr
+     */
+    static void freeRetired(Snapshot *retired)
+    {
+        while (retired != nullptr)
+        {
+            Snapshot *next = retired->m_retired;
+            freeSnapshot(retired);
+            retired = next;
+        }
+    }
+
+    /**
+     * @brief Number of ShardedSignal emits running on the calling thread
+     * @return uint32_t&
+     */
+    static uint32_t &emitDepth(void)
+    {
+        return ShardedSignalThread::emitDepth();
+    }
+
+    /**
+     * @brief Sequence number of the calling thread
+     * @return uint32_t
+     */
+    static uint32_t threadIndex(void)
+    {
+        return ShardedSignalThread::index();
+    }
+
+private:                 /*Parameter*/
+    uint8_t *m_memory;   /*!< Raw allocation of the shards */
+    Shard *m_shards;     /*!< Cache line aligned shards */
+    uint16_t m_num_shards; /*!< Number of shards */
+    std::atomic<uint32_t> m_epoch; /*!< Selects the reader counter new emits use */
+    std::mutex m_sync_mutex;       /*!< Serializes synchronize() */
+};
+
+#endif // EVENTSHARDEDSIGNAL_H
@@ -2,13 +2,10 @@
 #define EVENTSIGNAL_H
 
 #include <stdint.h>
-#ifdef ARDUINO_ARCH_AVR
-// #include "ArduinoSTL.h"
-// #include <vector>  // Entfernt, da wir Standardarrays verwenden
-#else
-// #include <vector>  // Entfernt, da wir Standardarrays verwenden
-#endif
+#include "EventConnections.h"
 #include "EventSlot.h"
+#include "EventTimer.h"
+#include "EventTrace.h"
 
 /**
  * @brief Signal-Hauptklasse
@@ -16,42 +13,22 @@
  *
  * Die Signal-Klasse ermöglicht es, Slots und andere Signale zu verbinden, um Rückrufe zu erhalten.
  * Beachten Sie, dass diese Rückrufe im Kontext eines Interrupts erfolgen können, daher sollte die Verarbeitung schnell sein.
+ *
+ * Ein Signal belegt nur ein Wort (siehe EventConnections): Erst beim ersten Verbinden wird ein Block angelegt, der alle
+ * Slots und Signale aufnimmt. Der Block waechst genau um die benoetigten Eintraege, um RAM zu sparen.
  */
 template <class... Type>
-class Signal
+class Signal : private EventConnections
 {
+    friend class EventWiring;
 
 public:
     /**
      * @brief Konstruktor für ein neues Signal-Objekt
      */
-    Signal(uint16_t max_connections = UINT16_MAX) : m_max_connections(max_connections),
-                                                    m_size_of_connections(0),
-                                                    m_connected_slots(nullptr),
-                                                    m_connected_signals(nullptr),
-                                                    m_num_connected_slots(0),
-                                                    m_num_connected_signals(0)
+    Signal(uint16_t max_connections = UINT16_MAX) : EventConnections(max_connections)
     {
-        /* Alle Listen werden mit nullptr initialisiert, um den RAM-Verbrauch zu reduzieren */
-    }
-
-    /**
-     * @brief Destruktor für das Signal-Objekt
-     *
-     * Da das Signal Kopien aller Eingangsslots über clone() nimmt, muss es beim Zerstören aufräumen.
-     */
-    virtual ~Signal()
-    {
-        if (m_connected_slots != nullptr)
-        {
-            delete[] m_connected_slots;
-            m_connected_slots = nullptr;
-        }
-        if (m_connected_signals != nullptr)
-        {
-            delete[] m_connected_signals;
-            m_connected_signals = nullptr;
-        }
+        /* Es wird kein Speicher reserviert, bis die erste Verbindung hergestellt wird */
     }
 
     /**
@@ -62,18 +39,7 @@ public:
      */
     void connect(const Signal<Type...> &signal)
     {
-        /* Signal-Liste erstellen, wenn das erste Signal angehängt wird */
-        if (m_connected_signals == nullptr)
-        {
-            m_connected_signals = new Signal<Type...> *[m_max_connections];
-            m_num_connected_signals = 0;
-        }
-
-        if (m_size_of_connections < m_max_connections)
-        {
-            m_connected_signals[m_num_connected_signals++] = (Signal<Type...> *)&signal;
-            m_size_of_connections++;
-        }
+        connectEntry(const_cast<Signal<Type...> *>(&signal), true, true);
     }
 
     /**
@@ -84,122 +50,116 @@ public:
      */
     void connect(const Slot<Type...> &slot)
     {
-        if (m_connected_slots == nullptr)
-        {
-            m_connected_slots = new Slot<Type...> *[m_max_connections];
-            m_num_connected_slots = 0;
-        }
-
-        if (m_size_of_connections < m_max_connections)
-        {
-            m_connected_slots[m_num_connected_slots++] = (Slot<Type...> *)&slot;
-            m_size_of_connections++;
-        }
+        connectEntry(const_cast<Slot<Type...> *>(&slot), false, true);
     }
 
     /**
      * @brief Trenne einen Slot
      * @param[in] slot Slot zum Trennen
      *
-     * Entfernt einen Slot aus der Liste der Verbindungen.
+     * Entfernt einen Slot aus der Liste der Verbindungen. Waehrend emit() laeuft, wird der Eintrag nur als leer markiert
+     * und erst nach dem Ende des aeussersten emit() entfernt.
      */
     void disconnect(const Slot<Type...> &slot)
     {
-        if (m_connected_slots != nullptr)
-        {
-            for (uint16_t i = 0; i < m_num_connected_slots; i++)
-            {
-                if (&slot == m_connected_slots[i])
-                {
-                    removeFromArray(m_connected_slots, m_num_connected_slots, i);
-                    m_size_of_connections--;
-                    break;
-                }
-            }
-        }
+        disconnectEntry(&slot, false);
     }
 
     /**
      * @brief Trenne ein Signal
      * @param[in] signal Signal zum Trennen
      *
-     * Entfernt ein Signal aus der Liste der Verbindungen.
+     * Entfernt ein Signal aus der Liste der Verbindungen. Waehrend emit() laeuft, wird der Eintrag nur als leer markiert
+     * und erst nach dem Ende des aeussersten emit() entfernt.
      */
     void disconnect(const Signal<Type...> &signal)
     {
-        if (m_connected_signals != nullptr)
-        {
-            for (uint16_t i = 0; i < m_num_connected_signals; i++)
-            {
-                if (&signal == m_connected_signals[i])
-                {
-                    removeFromArray(m_connected_signals, m_num_connected_signals, i);
-                    m_size_of_connections--;
-                    break;
-                }
-            }
-        }
+        disconnectEntry(&signal, true);
     }
 
     /**
      * @brief Emit-Funktion
      * @param args Parameter
      *
-     * Ruft alle verbundenen Slots und Signale auf.
+     * Ruft alle verbundenen Slots und Signale auf. Slots duerfen waehrend des Aufrufs Verbindungen dieses Signals
+     * herstellen oder trennen: Getrennte Verbindungen werden nicht mehr aufgerufen, neue Verbindungen erst beim naechsten
+     * emit().
      */
     void emit(Type... args) const
     {
-        if (m_connected_slots != nullptr)
+        EventConnectionBlock *block = connectionBlock();
+
+        if (block == nullptr)
         {
-            for (uint16_t i = 0; i < m_num_connected_slots; i++)
+            return;
+        }
+
+        const uint16_t num_slots = block->m_num_slots;
+        const uint16_t num_signals = block->m_num_signals;
+
+        EVENT_TRACE_EMIT_BEGIN(this);
+        beginEmit(block);
+
+        for (uint16_t i = 0; i < num_slots; i++)
+        {
+            Slot<Type...> *slot = static_cast<Slot<Type...> *>(slotEntry(i));
+            if (slot != nullptr)
             {
-                (*m_connected_slots[i])(args...);
+                EVENT_TRACE_SLOT_BEGIN(slot);
+                (*slot)(args...);
+                EVENT_TRACE_SLOT_END(slot);
             }
         }
 
-        if (m_connected_signals != nullptr)
+        for (uint16_t i = 0; i < num_signals; i++)
         {
-            for (uint16_t i = 0; i < m_num_connected_signals; i++)
+            Signal<Type...> *signal = static_cast<Signal<Type...> *>(signalEntry(i));
+            if (signal != nullptr)
             {
-                m_connected_signals[i]->emit(args...);
+                signal->emit(args...);
             }
         }
+
+        endEmit();
+        EVENT_TRACE_EMIT_END(this);
     }
 
     /**
-     * @brief Gibt die Anzahl der Verbindungen zurück
-     * @return uint16_t
+     * @brief Signal einmalig nach einer Verzoegerung senden
+     * @tparam Timer EventTimerWheel oder EventTimerThread
+     * @param timer Timer, der das Senden ausfuehrt
+     * @param delay Verzoegerung in Ticks des Timers
+     * @param args Parameter
+     * @return EventTimerHandle Handle zum Abbrechen
      */
-    uint16_t connections(void)
+    template <class Timer>
+    EventTimerHandle emitAfter(Timer &timer, uint32_t delay, Type... args) const
     {
-        return m_size_of_connections;
+        return timer.emitAfter(*this, delay, args...);
     }
 
-private: /* Methods */
-         /**
-          * @brief Entfernt ein Element aus einem Array und verschiebt die restlichen Elemente nach links
-          * @tparam T Typ des Arrays (Slot oder Signal)
-          * @param array Zeiger auf das Array
-          * @param num_elements Referenz auf die Anzahl der Elemente im Array
-          * @param index_to_remove Index des zu entfernenden Elements
-          */
-    template <typename T>
-    void removeFromArray(T **array, uint16_t &num_elements, uint16_t index_to_remove)
+    /**
+     * @brief Signal periodisch senden
+     * @tparam Timer EventTimerWheel oder EventTimerThread
+     * @param timer Timer, der das Senden ausfuehrt
+     * @param period Periode in Ticks des Timers
+     * @param args Parameter
+     * @return EventTimerHandle Handle zum Abbrechen
+     */
+    template <class Timer>
+    EventTimerHandle emitEvery(Timer &timer, uint32_t period, Type... args) const
     {
-        for (uint16_t j = index_to_remove; j < num_elements - 1; j++)
-        {
-            array[j] = array[j + 1];
-        }
-        num_elements--;
+        return timer.emitEvery(*this, period, args...);
     }
 
-private:                                   /*Parameter*/
-    uint16_t m_max_connections;            /*!< Maximale Anzahl von Verbindungen */
-    uint16_t m_size_of_connections;        /*!< Aktuelle Anzahl von Verbindungen */
-    Slot<Type...> **m_connected_slots;     /*!< Array von Zeigern auf Slots */
-    Signal<Type...> **m_connected_signals; /*!< Array von Zeigern auf Signale */
-    uint16_t m_num_connected_slots;        /*!< Anzahl der verbundenen Slots */
-    uint16_t m_num_connected_signals;      /*!< Anzahl der verbundenen Signale */
+    /**
+     * @brief Gibt die Anzahl der Verbindungen zurück
+     * @return uint16_t
+     */
+    uint16_t connections(void)
+    {
+        return connectionCount();
+    }
 };
 
 #endif // EVENTSIGNAL_H
@@ -2,13 +2,10 @@
 #define EVENTSIGNAL_H
 
 #include <stdint.h>
-#ifdef ARDUINO_ARCH_AVR
-// #include "ArduinoSTL.h"
-#include <vector>
-#else
-#include <vector>
-#endif
+#include "EventConnections.h"
 #include "EventSlot.h"
+#include "EventTimer.h"
+#include "EventTrace.h"
 
 /**
  * @brief Signal Main Class
@@ -17,32 +14,24 @@
  * The Signal class, we can implant these into ends and allow means to connect their members to them should they want to
  * receive callbacks from their children means. Ofcourse it's possible that these callbacks are made within the context of
  * an interrupt so the receipient will want to be fairly quick about how they process it.
+ *
+ * A Signal is a single word (see EventConnections): nothing is allocated until the first connect, and all slots and
+ * signals connected to it share one heap block which grows geometrically.
+ *
+ * emit() may run on several threads at the same time while the connections do not change. connect() and disconnect(),
+ * also from inside a slot, are only allowed while no other thread emits the signal (see EventConnections).
  */
 template <class... Type>
-class Signal
+class Signal : private EventConnections
 {
+    friend class EventWiring;
 
 public:
     /**
      * @brief Construct a new Signal object
      */
-    Signal(uint16_t max_connections = UINT16_MAX) : m_max_onnections(max_connections),
-                                                    m_size_of_connections(0)
-    {
-        /*All list are initiated whith null to reduce RAM usage*/
-        m_connected_signals = nullptr;
-        m_connected_slots = nullptr;
-    }
-
-    /**
-     * @brief Destroy the Signal object
-     *
-     * Since the signal takes copies of all the input slots via clone() it needs to clean up after itself when being destroyed.
-     */
-    virtual ~Signal()
+    Signal(uint16_t max_connections = UINT16_MAX) : EventConnections(max_connections)
     {
-        m_connected_slots->clear();
-        m_connected_signals->clear();
     }
 
     /**
@@ -53,17 +42,7 @@ public:
      */
     void connect(const Signal<Type...> &signal)
     {
-        /*Create Signal list for when the first Signal was attached*/
-        if (m_connected_signals == nullptr)
-        {
-            m_connected_signals = new std::vector<Signal<Type...> *>();
-        }
-
-        if (m_size_of_connections < m_max_onnections)
-        {
-            m_connected_signals->push_back((Signal<Type...> *)&signal);
-            m_size_of_connections++;
-        }
+        connectEntry(const_cast<Signal<Type...> *>(&signal), true, false);
     }
 
     /**
@@ -74,88 +53,107 @@ public:
      */
     void connect(const Slot<Type...> &slot)
     {
-        if (m_connected_slots == nullptr)
-        {
-            m_connected_slots = new std::vector<Slot<Type...> *>();
-        }
-
-        if (m_size_of_connections < m_max_onnections)
-        {
-            m_connected_slots->push_back((Slot<Type...> *)&slot);
-            m_size_of_connections++;
-        }
+        connectEntry(const_cast<Slot<Type...> *>(&slot), false, false);
     }
 
     /**
      * @brief Disconnect Slot
      * @param[in] slot Slot to disconnect
      *
-     * Removes slot from list of connections.
+     * Removes slot from list of connections. While emit() is running the entry is only cleared and removed after the
+     * outermost emit() returned.
      */
     void disconnect(const Slot<Type...> &slot)
     {
-        bool found = false;
-
-        if (m_connected_slots != nullptr)
-        {
-            for (int i = 0; i < m_connected_slots->size() && found == false; i++)
-            {
-                if (&slot == m_connected_slots->at(i))
-                {
-                    m_connected_slots->erase(i);
-                    m_size_of_connections--;
-                    found = true;
-                }
-            }
-        }
+        disconnectEntry(&slot, false);
     }
 
     /**
      * @brief Disconnect a Signal
      * @param[in] signal Signal reference to disconnect
      *
-     * Removes signal from list of connections.
+     * Removes signal from list of connections. While emit() is running the entry is only cleared and removed after the
+     * outermost emit() returned.
      */
     void disconnect(const Signal<Type...> &signal)
     {
-        bool found = false;
-        if (m_connected_signals != nullptr)
-        {
-            for (int i = 0; i < m_connected_signals->size() && found == false; i++)
-            {
-                if (&signal == m_connected_signals->at(i))
-                {
-                    m_connected_signals->erase(i);
-                    m_size_of_connections--;
-                    found = true;
-                }
-            }
-        }
+        disconnectEntry(&signal, true);
     }
 
     /**
      * @brief
      * @param param
      *
-     * Visits each of its listeners and executes them via operator().
+     * Visits each of its listeners and executes them via operator(). Listeners may connect or disconnect this signal
+     * while it is emitting: disconnected listeners are skipped, new listeners are called from the next emit() on. The
+     * entries are read by index from the current connection block, so a reallocation caused by a connect does not
+     * invalidate the loop.
      */
     void emit(Type... args) const
     {
-        if (m_connected_slots != nullptr)
+        EventConnectionBlock *block = connectionBlock();
+
+        if (block == nullptr)
         {
-            for (Slot<Type...> *conSlot : *m_connected_slots)
+            return;
+        }
+
+        const uint16_t num_slots = block->m_num_slots;
+        const uint16_t num_signals = block->m_num_signals;
+
+        EVENT_TRACE_EMIT_BEGIN(this);
+        beginEmit(block);
+
+        for (uint16_t i = 0; i < num_slots; i++)
+        {
+            Slot<Type...> *conSlot = static_cast<Slot<Type...> *>(slotEntry(i));
+            if (conSlot != nullptr)
             {
+                EVENT_TRACE_SLOT_BEGIN(conSlot);
                 (*conSlot)(args...);
+                EVENT_TRACE_SLOT_END(conSlot);
             }
         }
 
-        if (m_connected_signals != nullptr)
+        for (uint16_t i = 0; i < num_signals; i++)
         {
-            for (Signal<Type...> *conSignal : *m_connected_signals)
+            Signal<Type...> *conSignal = static_cast<Signal<Type...> *>(signalEntry(i));
+            if (conSignal != nullptr)
             {
                 conSignal->emit(args...);
             }
         }
+
+        endEmit();
+        EVENT_TRACE_EMIT_END(this);
+    }
+
+    /**
+     * @brief Emit the signal once after a delay
+     * @tparam Timer EventTimerWheel or EventTimerThread
+     * @param timer Timer which executes the emit
+     * @param delay Delay in ticks of the timer
+     * @param args Arguments of the emit
+     * @return EventTimerHandle Handle to cancel the emit
+     */
+    template <class Timer>
+    EventTimerHandle emitAfter(Timer &timer, uint32_t delay, Type... args) const
+    {
+        return timer.emitAfter(*this, delay, args...);
+    }
+
+    /**
+     * @brief Emit the signal periodically
+     * @tparam Timer EventTimerWheel or EventTimerThread
+     * @param timer Timer which executes the emits
+     * @param period Period in ticks of the timer
+     * @param args Arguments of every emit
+     * @return EventTimerHandle Handle to cancel the emits
+     */
+    template <class Timer>
+    EventTimerHandle emitEvery(Timer &timer, uint32_t period, Type... args) const
+    {
+        return timer.emitEvery(*this, period, args...);
     }
 
     /**
@@ -165,14 +163,8 @@ public:
 
     uint16_t connections(void)
     {
-        return m_size_of_connections;
+        return connectionCount();
     }
-
-private:
-    uint16_t m_max_onnections;                           /*!< */
-    uint16_t m_size_of_connections;                      /*!< */
-    std::vector<Slot<Type...> *> *m_connected_slots;     /*!< */
-    std::vector<Signal<Type...> *> *m_connected_signals; /*!< */
 };
 
 #endif // EVENTSIGNAL_H
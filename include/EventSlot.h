@@ -2,6 +2,11 @@
 #define EVENTSLOT_H
 
 #include <stdint.h>
+#include "Event_Config.h"
+
+#if (EVENT_USE_CPP_DEV_TYPE == EVENT_TYPE_STANDARD)
+#include <atomic>
+#endif
 
 /**
  * @brief Enumerate to identify SlotType
@@ -9,7 +14,9 @@
 enum SlotType
 {
     Function,
-    Method
+    Method,
+    MethodGroup,
+    Channel
 };
 
 /**
@@ -193,4 +200,227 @@ private:
     FunctPtr m_funct;  /*!< A function-pointer-to-method of class ObjectType. */
 };
 
+/**
+ * @brief
+ * @tparam ObjectType Class of the receivers
+ * @tparam MethodType Type of the member function, e.g. decltype(&ObjectType::method)
+ * @tparam Method Member function called on every receiver
+ *
+ * MethodSlotGroup is a subclass of Slot that binds one member function to many receiver objects of the same class.
+ * Instead of connecting hundreds of MethodSlot objects (one virtual call and one heap-resident slot per receiver), the
+ * group keeps a contiguous array of receivers and calls the member function on all of them in a single loop. The
+ * member function is a template parameter, so the call inside the loop is a direct call the compiler can inline; only
+ * the call of the group itself goes through the virtual Slot::operator(). The receivers are either a pointer array
+ * owned by the group (see add() / remove()) or a caller-owned contiguous array of whole receiver objects, which is
+ * walked directly. The latter is an array of objects, not a structure of arrays: the loop only avoids the pointer
+ * indirection, each call still accesses its object.
+ *
+ * Receivers may add or remove receivers of the group while it executes. A removed receiver is skipped and cleared from
+ * the array after the outermost call returned; added receivers are called from the next call on, unless the array is
+ * full and they take the place of a receiver removed in the same call.
+ */
+template <class ObjectType, class MethodType, MethodType Method>
+class MethodSlotGroup;
+
+template <class ObjectType, class... Type, void (ObjectType::*Method)(Type...)>
+class MethodSlotGroup<ObjectType, void (ObjectType::*)(Type...), Method> : public Slot<Type...>
+{
+
+public:
+    /**
+     * @brief Construct a new Method Slot Group object with an owned receiver pointer array
+     * @param max_receivers Maximum number of receivers which can be added
+     */
+    MethodSlotGroup(uint16_t max_receivers) : Slot<Type...>(MethodGroup),
+                                              m_receivers(new ObjectType *[max_receivers]),
+                                              m_objects(nullptr),
+                                              m_max_receivers(max_receivers),
+                                              m_num_receivers(0),
+                                              m_num_removed(0),
+                                              m_dispatch_depth(0)
+    {
+    }
+
+    /**
+     * @brief Construct a new Method Slot Group object over a contiguous array of receiver objects
+     * @param objects Caller owned array of receivers, has to outlive the group
+     * @param num_objects Number of objects in the array, ignored if objects is nullptr
+     */
+    MethodSlotGroup(ObjectType *objects, uint16_t num_objects) : Slot<Type...>(MethodGroup),
+                                                                 m_receivers(nullptr),
+                                                                 m_objects(objects),
+                                                                 m_max_receivers((objects != nullptr) ? num_objects : 0),
+                                                                 m_num_receivers((objects != nullptr) ? num_objects : 0),
+                                                                 m_num_removed(0),
+                                                                 m_dispatch_depth(0)
+    {
+    }
+
+    MethodSlotGroup(const MethodSlotGroup &) = delete;
+    MethodSlotGroup &operator=(const MethodSlotGroup &) = delete;
+
+    /**
+     * @brief Destroy the Method Slot Group object
+     */
+    ~MethodSlotGroup()
+    {
+        if (m_receivers != nullptr)
+        {
+            delete[] m_receivers;
+            m_receivers = nullptr;
+        }
+    }
+
+    /**
+     * @brief Add a receiver to the group
+     * @param obj Receiver object
+     * @return true Receiver was added
+     * @return false Group is full or was created over an object array
+     */
+    bool add(ObjectType *obj)
+    {
+        if ((m_receivers == nullptr) || (obj == nullptr) || (size() >= m_max_receivers))
+        {
+            return false;
+        }
+
+        if (m_num_receivers < m_max_receivers)
+        {
+            m_receivers[m_num_receivers++] = obj;
+        }
+        else
+        {
+            /* Full with receivers removed during the running call, reuse one of their entries */
+            uint16_t i = 0;
+            while (m_receivers[i] != nullptr)
+            {
+                i++;
+            }
+            m_receivers[i] = obj;
+            m_num_removed--;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Remove a receiver from the group
+     * @param obj Receiver object
+     * @return true Receiver was found and removed
+     * @return false Receiver is not part of the group
+     *
+     * The order of the remaining receivers is preserved. While the group executes, the entry is only cleared and
+     * removed after the outermost call returned.
+     */
+    bool remove(ObjectType *obj)
+    {
+        if ((m_receivers != nullptr) && (obj != nullptr))
+        {
+            for (uint16_t i = 0; i < m_num_receivers; i++)
+            {
+                if (m_receivers[i] == obj)
+                {
+                    m_receivers[i] = nullptr;
+                    m_num_removed++;
+                    if (m_dispatch_depth == 0)
+                    {
+                        compact();
+                    }
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Number of receivers in the group
+     * @return uint16_t
+     */
+    uint16_t size(void) const
+    {
+        return m_num_receivers - m_num_removed;
+    }
+
+    /**
+     * @brief
+     * @param param
+     *
+     * Execute the member function on every receiver of the group.
+     */
+    void operator()(Type... args) const
+    {
+        const uint16_t num_receivers = m_num_receivers;
+
+        if (m_objects != nullptr)
+        {
+            ObjectType *objects = m_objects;
+            for (uint16_t i = 0; i < num_receivers; i++)
+            {
+                (objects[i].*Method)(args...);
+            }
+        }
+        else
+        {
+            ObjectType *const *receivers = m_receivers;
+
+            m_dispatch_depth++;
+            for (uint16_t i = 0; i < num_receivers; i++)
+            {
+                ObjectType *receiver = receivers[i];
+                if (receiver != nullptr)
+                {
+                    (receiver->*Method)(args...);
+                }
+            }
+            if ((--m_dispatch_depth == 0) && (m_num_removed != 0))
+            {
+                const_cast<MethodSlotGroup *>(this)->compact();
+            }
+        }
+    }
+
+    /**
+     * @brief
+     * @param slot
+     * @return true
+     * @return false
+     *
+     * Compare the slot. Groups cannot be copied, so a group is only equal to itself.
+     */
+    bool operator==(const Slot<Type...> *slot) const
+    {
+        return slot == this;
+    }
+
+private:
+    /**
+     * @brief Remove the cleared entries of the receiver array
+     */
+    void compact(void)
+    {
+        uint16_t used = 0;
+        for (uint16_t i = 0; i < m_num_receivers; i++)
+        {
+            if (m_receivers[i] != nullptr)
+            {
+                m_receivers[used++] = m_receivers[i];
+            }
+        }
+        m_num_receivers = used;
+        m_num_removed = 0;
+    }
+
+private:
+    ObjectType **m_receivers;   /*!< Owned array of receiver pointers, nullptr when an object array is used. */
+    ObjectType *m_objects;      /*!< Caller owned contiguous array of receivers, nullptr when receivers are added. */
+    uint16_t m_max_receivers;   /*!< Capacity of the receiver array. */
+    uint16_t m_num_receivers;   /*!< Number of used entries, including cleared ones. */
+    uint16_t m_num_removed;     /*!< Entries cleared while the group executes. */
+#if (EVENT_USE_CPP_DEV_TYPE == EVENT_TYPE_STANDARD)
+    mutable std::atomic<uint8_t> m_dispatch_depth; /*!< Number of running calls, nested or on other threads. */
+#else
+    mutable uint8_t m_dispatch_depth;              /*!< Nesting depth of running calls. */
+#endif
+};
+
 #endif // EVENTSLOT_H
@@ -0,0 +1,637 @@
+#ifndef EVENTTIMER_H
+#define EVENTTIMER_H
+
+#include <stdint.h>
+#include <new>
+#include "Event_Config.h"
+
+#if (EVENT_USE_CPP_DEV_TYPE == EVENT_TYPE_STANDARD)
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#endif
+
+/**
+ * @brief Forward decleartion of the clas Signal
+ */
+template <class... Type> class Signal;
+
+/**
+ * @brief Handle of a scheduled emit
+ *
+ * A handle stays valid until the timer fired (one shot) or was cancelled. Since the pool entries are reused, the
+ * handle carries a generation counter so that a stale handle never cancels a newer timer.
+ */
+struct EventTimerHandle
+{
+    uint16_t m_index;      /*!< Index of the timer in the pool */
+    uint16_t m_generation; /*!< Generation of the pool entry when the timer was scheduled */
+
+    /**
+     * @brief Check if the handle refers to a scheduled timer
+     * @return true Handle was returned by a successful schedule call
+     * @return false Pool was exhausted when scheduling
+     */
+    bool valid(void) const
+    {
+        return m_index != UINT16_MAX;
+    }
+};
+
+/**
+ * @brief Helper to exclude the emit arguments from template argument deduction
+ * @tparam T Parameter type of the signal
+ *
+ * The argument types of emitAfter() / emitEvery() are taken from the signal only, so emitAfter(floatSignal, 10, 1)
+ * stores a float and not an int.
+ */
+template <class T>
+struct EventTimerArg
+{
+    typedef T type;
+};
+
+/**
+ * @brief Hierarchical timer wheel for delayed and periodic emits
+ *
+ * The wheel consists of EVENT_TIMER_WHEEL_LEVELS levels with 2^EVENT_TIMER_WHEEL_BITS buckets each. A timer is placed in
+ * the bucket of the lowest level which covers its remaining delay and moves down one level each time the higher level
+ * bucket comes due. Scheduling and cancelling are O(1), tick() is amortized O(1) per elapsed tick.
+ *
+ * The timers and the pending emit arguments live in a fixed pool of EVENT_TIMER_POOL_SIZE entries inside the wheel,
+ * nothing is allocated after construction. The arguments of one emit may use up to EVENT_TIMER_PAYLOAD_SIZE bytes.
+ *
+ * The wheel itself is not thread safe and must not be used from interrupts. Call tick() from loop() with the current
+ * time (e.g. millis()), or use EventTimerThread on the standard backend. A wheel constructed without a start time takes
+ * the time of the first tick() as its start, so emits scheduled in setup() are counted from there.
+ *
+ * A pending emit only stores a reference to its signal. The signal has to outlive the emit, i.e. cancel the emit
+ * before a signal with a shorter lifetime than the wheel is destroyed.
+ */
+class EventTimerWheel
+{
+    static const uint16_t BUCKETS = (1u << EVENT_TIMER_WHEEL_BITS);
+    static const uint32_t MASK = (BUCKETS - 1u);
+    static const uint32_t RANGE = (EVENT_TIMER_WHEEL_BITS * EVENT_TIMER_WHEEL_LEVELS >= 32u)
+                                      ? UINT32_MAX
+                                      : ((1ul << (EVENT_TIMER_WHEEL_BITS * EVENT_TIMER_WHEEL_LEVELS)) - 1u);
+
+    /**
+     * @brief State of a pool entry
+     */
+    enum NodeState
+    {
+        Free,
+        Pending,
+        Firing,
+        Cancelled
+    };
+
+    /**
+     * @brief Pool entry of the wheel, holds one scheduled emit
+     */
+    struct Node
+    {
+        Node *m_next;                /*!< Next node in the bucket or free list */
+        Node *m_prev;                /*!< Previous node in the bucket */
+        Node **m_bucket;             /*!< Bucket the node is linked into */
+        uint32_t m_expires;          /*!< Tick when the emit is due */
+        uint32_t m_period;           /*!< Period of the emit, 0 for one shot emits */
+        uint16_t m_generation;       /*!< Incremented each time the node is released */
+        uint8_t m_state;             /*!< NodeState of the entry */
+        void (*m_invoke)(void *);    /*!< Executes the stored emit */
+        void (*m_destroy)(void *);   /*!< Destroys the stored emit arguments */
+        union
+        {
+            uint8_t m_bytes[EVENT_TIMER_PAYLOAD_SIZE];
+            void *m_align_ptr;
+            double m_align_double;
+            uint32_t m_align_uint32;
+        } m_payload;                 /*!< Inline storage of the signal reference and the emit arguments */
+    };
+
+public:
+    /**
+     * @brief Construct a new Timer Wheel object which starts with the first tick()
+     */
+    EventTimerWheel() : EventTimerWheel(0)
+    {
+        m_started = false;
+    }
+
+    /**
+     * @brief Construct a new Timer Wheel object
+     * @param now Current time, all delays are counted from here
+     */
+    explicit EventTimerWheel(uint32_t now) : m_free(nullptr),
+                                             m_current(now + 1u),
+                                             m_active(0),
+                                             m_ticking(false),
+                                             m_started(true)
+    {
+        for (uint16_t level = 0; level < EVENT_TIMER_WHEEL_LEVELS; level++)
+        {
+            for (uint16_t i = 0; i < BUCKETS; i++)
+            {
+                m_buckets[level][i] = nullptr;
+            }
+        }
+
+        for (uint16_t i = EVENT_TIMER_POOL_SIZE; i > 0; i--)
+        {
+            Node *node = &m_pool[i - 1];
+            node->m_generation = 0;
+            node->m_state = Free;
+            node->m_next = m_free;
+            m_free = node;
+        }
+    }
+
+    EventTimerWheel(const EventTimerWheel &) = delete;
+    EventTimerWheel &operator=(const EventTimerWheel &) = delete;
+
+    /**
+     * @brief Destroy the Timer Wheel object
+     *
+     * Pending emits are dropped without being executed.
+     */
+    ~EventTimerWheel()
+    {
+        for (uint16_t i = 0; i < EVENT_TIMER_POOL_SIZE; i++)
+        {
+            if (m_pool[i].m_state != Free)
+            {
+                m_pool[i].m_destroy(m_pool[i].m_payload.m_bytes);
+            }
+        }
+    }
+
+    /**
+     * @brief Emit a signal once after a delay
+     * @param signal Signal to emit, has to outlive the pending emit
+     * @param delay Delay in ticks from the last tick() or the start time, 0 is due on the next tick
+     * @param args Arguments of the emit, copied into the pool
+     * @return EventTimerHandle Handle to cancel the emit, invalid if the pool is exhausted
+     */
+    template <class... Type>
+    EventTimerHandle emitAfter(const Signal<Type...> &signal, uint32_t delay, typename EventTimerArg<Type>::type... args)
+    {
+        return schedule(delay, 0, [&signal, args...]()
+                        { signal.emit(args...); });
+    }
+
+    /**
+     * @brief Emit a signal periodically
+     * @param signal Signal to emit, has to outlive the pending emits
+     * @param period Period in ticks, the first emit happens one period after the last tick() or the start time
+     * @param args Arguments of every emit, copied into the pool
+     * @return EventTimerHandle Handle to cancel the emits, invalid if the pool is exhausted
+     */
+    template <class... Type>
+    EventTimerHandle emitEvery(const Signal<Type...> &signal, uint32_t period, typename EventTimerArg<Type>::type... args)
+    {
+        if (period == 0)
+        {
+            period = 1;
+        }
+        return schedule(period, period, [&signal, args...]()
+                        { signal.emit(args...); });
+    }
+
+    /**
+     * @brief Cancel a scheduled emit
+     * @param handle Handle returned by emitAfter() or emitEvery()
+     * @return true Emit was pending and is cancelled
+     * @return false Handle is invalid, already fired or cancelled
+     *
+     * A periodic emit may cancel itself from inside one of its slots.
+     */
+    bool cancel(EventTimerHandle handle)
+    {
+        Node *node = lookup(handle);
+
+        if (node == nullptr)
+        {
+            return false;
+        }
+
+        if (node->m_state == Firing)
+        {
+            node->m_state = Cancelled;
+        }
+        else
+        {
+            unlink(node);
+            release(node);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Check if an emit is still scheduled
+     * @param handle Handle returned by emitAfter() or emitEvery()
+     * @return true Emit will still be executed
+     * @return false Emit fired, was cancelled or the handle is invalid
+     */
+    bool pending(EventTimerHandle handle) const
+    {
+        return lookup(handle) != nullptr;
+    }
+
+    /**
+     * @brief Number of scheduled emits
+     * @return uint16_t
+     */
+    uint16_t active(void) const
+    {
+        return m_active;
+    }
+
+    /**
+     * @brief Advance the wheel and execute all emits which are due
+     * @param now Current time in ticks, e.g. millis()
+     *
+     * The time may wrap around, only the difference to the last call is relevant.
+     */
+    void tick(uint32_t now)
+    {
+        if (!m_started)
+        {
+            start(now);
+        }
+
+        m_ticking = true;
+
+        while ((int32_t)(now - m_current) >= 0)
+        {
+            uint32_t index = m_current & MASK;
+
+            /* Move the timers of the higher levels down when the lower level wrapped around */
+            for (uint16_t level = 1; (index == 0) && (level < EVENT_TIMER_WHEEL_LEVELS); level++)
+            {
+                index = (m_current >> (EVENT_TIMER_WHEEL_BITS * level)) & MASK;
+                cascade(level, index);
+            }
+
+            Node **bucket = &m_buckets[0][m_current & MASK];
+            while (*bucket != nullptr)
+            {
+                Node *node = *bucket;
+                unlink(node);
+
+                if (node->m_expires != m_current)
+                {
+                    /* Delay was larger than the range of the wheel */
+                    insert(node);
+                }
+                else
+                {
+                    fire(node);
+                }
+            }
+            m_current++;
+        }
+
+        m_ticking = false;
+    }
+
+private: /* Methods */
+    /**
+     * @brief Move the start of the wheel to the time of the first tick()
+     * @param now Time of the first tick
+     *
+     * Emits scheduled before keep their delay relative to the new start.
+     */
+    void start(uint32_t now)
+    {
+        const uint32_t offset = now - (m_current - 1u);
+
+        for (uint16_t i = 0; i < EVENT_TIMER_POOL_SIZE; i++)
+        {
+            if (m_pool[i].m_state == Pending)
+            {
+                unlink(&m_pool[i]);
+            }
+        }
+
+        m_current = now + 1u;
+        m_started = true;
+
+        for (uint16_t i = 0; i < EVENT_TIMER_POOL_SIZE; i++)
+        {
+            if (m_pool[i].m_state == Pending)
+            {
+                m_pool[i].m_expires += offset;
+                insert(&m_pool[i]);
+            }
+        }
+    }
+
+    /**
+     * @brief Run the stored emit of a node and reschedule it if it is periodic
+     * @param node Node which is due
+     */
+    void fire(Node *node)
+    {
+        node->m_state = Firing;
+        node->m_invoke(node->m_payload.m_bytes);
+
+        if ((node->m_state == Firing) && (node->m_period != 0))
+        {
+            node->m_state = Pending;
+            node->m_expires += node->m_period;
+            insert(node);
+        }
+        else
+        {
+            release(node);
+        }
+    }
+
+    /**
+     * @brief Take a node from the pool and store the emit in it
+     * @tparam F Type of the emit functor
+     * @param delay Delay of the first emit
+     * @param period Period of the emit, 0 for one shot
+     * @param funct Emit functor, holds the signal reference and the arguments
+     * @return EventTimerHandle
+     */
+    template <class F>
+    EventTimerHandle schedule(uint32_t delay, uint32_t period, const F &funct)
+    {
+        static_assert(sizeof(F) <= EVENT_TIMER_PAYLOAD_SIZE, "Emit arguments exceed EVENT_TIMER_PAYLOAD_SIZE");
+        static_assert(alignof(F) <= alignof(decltype(Node::m_payload)), "Emit arguments are over aligned");
+
+        EventTimerHandle handle = {UINT16_MAX, 0};
+        Node *node = m_free;
+
+        if (node != nullptr)
+        {
+            m_free = node->m_next;
+            new (node->m_payload.m_bytes) F(funct);
+            node->m_invoke = &invokePayload<F>;
+            node->m_destroy = &destroyPayload<F>;
+            node->m_period = period;
+            node->m_state = Pending;
+            /* Delays count from the tick being processed or the last processed one, never due on that tick itself */
+            node->m_expires = m_current - (m_ticking ? 0u : 1u) + ((delay == 0) ? 1u : delay);
+            insert(node);
+            m_active++;
+
+            handle.m_index = (uint16_t)(node - m_pool);
+            handle.m_generation = node->m_generation;
+        }
+        return handle;
+    }
+
+    /**
+     * @brief Link a node into the bucket which covers its remaining delay
+     * @param node Node to insert
+     */
+    void insert(Node *node)
+    {
+        uint32_t delta = node->m_expires - m_current;
+        uint32_t expires = node->m_expires;
+        uint16_t level = 0;
+
+        if (delta > RANGE)
+        {
+            delta = RANGE;
+            expires = m_current + RANGE;
+        }
+
+        while ((level < EVENT_TIMER_WHEEL_LEVELS - 1u) && ((delta >> (EVENT_TIMER_WHEEL_BITS * (level + 1u))) != 0))
+        {
+            level++;
+        }
+
+        Node **bucket = &m_buckets[level][(expires >> (EVENT_TIMER_WHEEL_BITS * level)) & MASK];
+        node->m_bucket = bucket;
+        node->m_prev = nullptr;
+        node->m_next = *bucket;
+        if (*bucket != nullptr)
+        {
+            (*bucket)->m_prev = node;
+        }
+        *bucket = node;
+    }
+
+    /**
+     * @brief Remove a node from its bucket
+     * @param node Node to remove
+     */
+    void unlink(Node *node)
+    {
+        if (node->m_prev != nullptr)
+        {
+            node->m_prev->m_next = node->m_next;
+        }
+        else
+        {
+            *node->m_bucket = node->m_next;
+        }
+
+        if (node->m_next != nullptr)
+        {
+            node->m_next->m_prev = node->m_prev;
+        }
+        node->m_next = nullptr;
+        node->m_prev = nullptr;
+    }
+
+    /**
+     * @brief Reinsert all nodes of a higher level bucket into the lower levels
+     * @param level Level of the bucket
+     * @param index Index of the bucket
+     */
+    void cascade(uint16_t level, uint32_t index)
+    {
+        Node *node = m_buckets[level][index];
+        m_buckets[level][index] = nullptr;
+
+        while (node != nullptr)
+        {
+            Node *next = node->m_next;
+            insert(node);
+            node = next;
+        }
+    }
+
+    /**
+     * @brief Destroy the emit arguments and return the node to the pool
+     * @param node Node to release
+     */
+    void release(Node *node)
+    {
+        node->m_destroy(node->m_payload.m_bytes);
+        node->m_state = Free;
+        node->m_generation++;
+        node->m_next = m_free;
+        m_free = node;
+        m_active--;
+    }
+
+    /**
+     * @brief Resolve a handle to its node
+     * @param handle Handle to resolve
+     * @return Node* Node if the handle refers to a pending emit, otherwise nullptr
+     */
+    Node *lookup(EventTimerHandle handle) const
+    {
+        if (handle.m_index < EVENT_TIMER_POOL_SIZE)
+        {
+            const Node *node = &m_pool[handle.m_index];
+            if ((node->m_generation == handle.m_generation) &&
+                ((node->m_state == Pending) || (node->m_state == Firing)))
+            {
+                return const_cast<Node *>(node);
+            }
+        }
+        return nullptr;
+    }
+
+    template <class F>
+    static void invokePayload(void *payload)
+    {
+        (*static_cast<F *>(payload))();
+    }
+
+    template <class F>
+    static void destroyPayload(void *payload)
+    {
+        static_cast<F *>(payload)->~F();
+    }
+
+private:                                                        /*Parameter*/
+    Node *m_buckets[EVENT_TIMER_WHEEL_LEVELS][1u << EVENT_TIMER_WHEEL_BITS]; /*!< Bucket lists of all levels */
+    Node m_pool[EVENT_TIMER_POOL_SIZE];                         /*!< Pool of timers and pending emit arguments */
+    Node *m_free;                                               /*!< Free list of the pool */
+    uint32_t m_current;                                         /*!< Next tick to be processed, the last one is m_current - 1 */
+    uint16_t m_active;                                          /*!< Number of scheduled emits */
+    bool m_ticking;                                             /*!< tick() is executing emits */
+    bool m_started;                                             /*!< m_current is synchronized with the caller's time */
+};
+
+#if (EVENT_USE_CPP_DEV_TYPE == EVENT_TYPE_STANDARD)
+
+/**
+ * @brief Timer wheel driven by a dedicated thread
+ *
+ * The thread advances the wheel once per millisecond, so all delays and periods are given in milliseconds. The
+ * scheduled emits are executed on the timer thread. Scheduling and cancelling are thread safe and can also be done from
+ * inside a slot executed by the timer.
+ *
+ * A signal emitted by the timer and by another thread at the same time must not be connected or disconnected in the
+ * meantime, not even from one of its slots.
+ */
+class EventTimerThread
+{
+public:
+    /**
+     * @brief Construct a new Timer Thread object and start the thread
+     */
+    EventTimerThread() : m_wheel(0),
+                         m_running(true),
+                         m_start(std::chrono::steady_clock::now())
+    {
+        m_thread = std::thread(&EventTimerThread::run, this);
+    }
+
+    EventTimerThread(const EventTimerThread &) = delete;
+    EventTimerThread &operator=(const EventTimerThread &) = delete;
+
+    /**
+     * @brief Destroy the Timer Thread object
+     *
+     * Stops the thread, pending emits are dropped.
+     */
+    ~EventTimerThread()
+    {
+        stop();
+    }
+
+    /**
+     * @brief Stop the timer thread
+     */
+    void stop(void)
+    {
+        m_running = false;
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+    }
+
+    /**
+     * @brief Emit a signal once after a delay
+     * @see EventTimerWheel::emitAfter()
+     */
+    template <class... Type>
+    EventTimerHandle emitAfter(const Signal<Type...> &signal, uint32_t delay_ms, typename EventTimerArg<Type>::type... args)
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_mutex);
+        return m_wheel.emitAfter(signal, delay_ms, args...);
+    }
+
+    /**
+     * @brief Emit a signal periodically
+     * @see EventTimerWheel::emitEvery()
+     */
+    template <class... Type>
+    EventTimerHandle emitEvery(const Signal<Type...> &signal, uint32_t period_ms, typename EventTimerArg<Type>::type... args)
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_mutex);
+        return m_wheel.emitEvery(signal, period_ms, args...);
+    }
+
+    /**
+     * @brief Cancel a scheduled emit
+     * @see EventTimerWheel::cancel()
+     */
+    bool cancel(EventTimerHandle handle)
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_mutex);
+        return m_wheel.cancel(handle);
+    }
+
+    /**
+     * @brief Check if an emit is still scheduled
+     * @see EventTimerWheel::pending()
+     */
+    bool pending(EventTimerHandle handle)
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_mutex);
+        return m_wheel.pending(handle);
+    }
+
+private: /* Methods */
+    /**
+     * @brief Thread function, ticks the wheel every millisecond
+     */
+    void run(void)
+    {
+        while (m_running)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+            uint32_t now = (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+                               std::chrono::steady_clock::now() - m_start)
+                               .count();
+
+            std::lock_guard<std::recursive_mutex> lock(m_mutex);
+            m_wheel.tick(now);
+        }
+    }
+
+private:                                           /*Parameter*/
+    EventTimerWheel m_wheel;                       /*!< Wheel holding the scheduled emits */
+    std::recursive_mutex m_mutex;                  /*!< Protects the wheel, recursive for scheduling from slots */
+    std::atomic<bool> m_running;                   /*!< Thread keeps running while set */
+    std::chrono::steady_clock::time_point m_start; /*!< Time of tick 0 */
+    std::thread m_thread;                          /*!< Timer thread */
+};
+
+#endif
+
+#endif // EVENTTIMER_H
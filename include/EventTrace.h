@@ -0,0 +1,417 @@
+#ifndef EVENTTRACE_H
+#define EVENTTRACE_H
+
+#include "Event_Config.h"
+
+#if (EVENT_TRACE_ENABLED != 0)
+
+#if (EVENT_USE_CPP_DEV_TYPE != EVENT_TYPE_STANDARD)
+#error "!!!!EVENT_TRACE_ENABLED requires EVENT_USE_CPP_DEV_TYPE == EVENT_TYPE_STANDARD!!!!"
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+
+/**
+ * @brief One begin or end record of a trace span
+ */
+struct EventTraceRecord
+{
+    uint64_t m_timestamp_ns; /*!< Time since the trace epoch */
+    const void *m_object;    /*!< Signal or slot of the span */
+    uint64_t m_id;           /*!< Id of the span, unique over all threads */
+    uint64_t m_parent;       /*!< Id of the enclosing emit span on the same thread, 0 if none */
+    uint8_t m_phase;         /*!< EventTrace::Begin or EventTrace::End */
+    uint8_t m_kind;          /*!< EventTrace::Emit or EventTrace::Invoke */
+};
+
+/**
+ * @brief Trace buffer of one thread
+ *
+ * Only the owning thread writes to the buffer. A record is published by a release store of m_count, so the exporter
+ * can read all records below m_count without a lock. When the buffer is full new spans are dropped; an end record
+ * always has room once its begin record was written.
+ */
+struct EventTraceBuffer
+{
+    EventTraceRecord m_records[EVENT_TRACE_BUFFER_SIZE]; /*!< Recorded begin and end records */
+    std::atomic<uint32_t> m_count;                      /*!< Number of published records */
+    std::atomic<uint32_t> m_dropped;                    /*!< Number of dropped spans */
+    uint32_t m_thread_index;                            /*!< Trace thread id */
+    uint64_t m_next_id;                                 /*!< Sequence of span ids of the thread */
+    EventTraceBuffer *m_next;                           /*!< Next buffer in the list of all threads */
+};
+
+/**
+ * @brief Span stack of one thread
+ *
+ * The stack is tracked even while recording is stopped, so that spans which are open when start() or stop() is called
+ * stay balanced. The trace buffer is only allocated when the thread records its first span.
+ */
+struct EventTraceThread
+{
+    /**
+     * @brief Open span on the span stack of the thread
+     */
+    struct Span
+    {
+        uint64_t m_id;  /*!< Id of the span, 0 if its begin record was not written */
+        uint8_t m_kind; /*!< EventTrace::Emit or EventTrace::Invoke */
+    };
+
+    EventTraceBuffer *m_buffer;          /*!< Trace buffer of the thread, nullptr until the first record */
+    Span m_stack[EVENT_TRACE_MAX_DEPTH]; /*!< Open spans of the thread */
+    uint16_t m_depth;                    /*!< Number of open spans, may exceed the stack */
+};
+
+/**
+ * @brief Causal tracing of emit chains
+ *
+ * With EVENT_TRACE_ENABLED set, every Signal::emit() and every slot it executes is recorded as a begin / end span
+ * together with the thread and the enclosing emit. Recording is switched on with start(); each thread writes into its
+ * own buffer of EVENT_TRACE_BUFFER_SIZE records without locking. exportChromeTrace() writes all buffers as a Chrome trace
+ * JSON file, which can be opened in chrome://tracing or in the Perfetto UI to see the cascade of an emit as flame chart.
+ *
+ * Thread buffers are kept until the program ends, so spans of finished threads can still be exported.
+ */
+class EventTrace
+{
+public:
+    /**
+     * @brief Phase of a record
+     */
+    enum Phase
+    {
+        Begin,
+        End
+    };
+
+    /**
+     * @brief Kind of a span
+     */
+    enum Kind
+    {
+        Emit,
+        Invoke
+    };
+
+    /**
+     * @brief Start recording
+     */
+    static void start(void)
+    {
+        epoch();
+        enabled().store(true, std::memory_order_release);
+    }
+
+    /**
+     * @brief Stop recording
+     *
+     * Spans which are open keep recording their end records.
+     */
+    static void stop(void)
+    {
+        enabled().store(false, std::memory_order_release);
+    }
+
+    /**
+     * @brief Check if recording is active
+     * @return true
+     * @return false
+     */
+    static bool active(void)
+    {
+        return enabled().load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Set the name of a signal or slot shown in the trace
+     * @param object Signal or slot
+     * @param name Name of the object
+     */
+    static void setName(const void *object, const char *name)
+    {
+        std::lock_guard<std::mutex> lock(namesMutex());
+        names()[object] = name;
+    }
+
+    /**
+     * @brief Discard all records
+     *
+     * Must only be called while no thread is emitting.
+     */
+    static void clear(void)
+    {
+        for (EventTraceBuffer *buffer = buffers().load(std::memory_order_acquire); buffer != nullptr; buffer = buffer->m_next)
+        {
+            buffer->m_count.store(0, std::memory_order_release);
+            buffer->m_dropped.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Number of spans dropped because a thread buffer was full
+     * @return uint32_t
+     */
+    static uint32_t dropped(void)
+    {
+        uint32_t dropped = 0;
+        for (EventTraceBuffer *buffer = buffers().load(std::memory_order_acquire); buffer != nullptr; buffer = buffer->m_next)
+        {
+            dropped += buffer->m_dropped.load(std::memory_order_relaxed);
+        }
+        return dropped;
+    }
+
+    /**
+     * @brief Write all records as Chrome trace JSON
+     * @param path File to write
+     * @return true File was written
+     * @return false File could not be opened
+     */
+    static bool exportChromeTrace(const char *path)
+    {
+        FILE *file = fopen(path, "w");
+        bool first = true;
+
+        if (file == nullptr)
+        {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(namesMutex());
+
+        fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+        for (EventTraceBuffer *buffer = buffers().load(std::memory_order_acquire); buffer != nullptr; buffer = buffer->m_next)
+        {
+            const uint32_t count = buffer->m_count.load(std::memory_order_acquire);
+
+            for (uint32_t i = 0; i < count; i++)
+            {
+                const EventTraceRecord &record = buffer->m_records[i];
+                const double ts = (double)record.m_timestamp_ns / 1000.0;
+
+                fprintf(file, "%s\n", first ? "" : ",");
+                first = false;
+
+                if (record.m_phase == Begin)
+                {
+                    fprintf(file, "{\"ph\":\"B\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"cat\":\"%s\",\"name\":\"",
+                            (unsigned)buffer->m_thread_index, ts, (record.m_kind == Emit) ? "emit" : "slot");
+                    writeName(file, record.m_object, (EventTrace::Kind)record.m_kind);
+                    fprintf(file, "\",\"args\":{\"object\":\"%p\",\"span\":%llu,\"parent_emit\":%llu}}",
+                            record.m_object, (unsigned long long)record.m_id, (unsigned long long)record.m_parent);
+                }
+                else
+                {
+                    fprintf(file, "{\"ph\":\"E\",\"pid\":1,\"tid\":%u,\"ts\":%.3f}", (unsigned)buffer->m_thread_index, ts);
+                }
+            }
+        }
+        fprintf(file, "\n]}\n");
+
+        return fclose(file) == 0;
+    }
+
+    /**
+     * @brief Open a span, called by the trace macros
+     * @param object Signal or slot
+     * @param kind Emit or Invoke
+     */
+    static void begin(const void *object, Kind kind)
+    {
+        EventTraceThread &thread = localThread();
+        const uint16_t depth = thread.m_depth++;
+        uint64_t id = 0;
+
+        if (depth < EVENT_TRACE_MAX_DEPTH)
+        {
+            if (active())
+            {
+                EventTraceBuffer &buffer = localBuffer(thread);
+                const uint32_t count = buffer.m_count.load(std::memory_order_relaxed);
+
+                /* Keep room for the end records of all open spans */
+                if (count + depth + 2u <= EVENT_TRACE_BUFFER_SIZE)
+                {
+                    id = buffer.m_next_id++;
+                    write(buffer, count, object, id, parentEmit(thread, depth), Begin, kind);
+                }
+                else
+                {
+                    buffer.m_dropped.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            thread.m_stack[depth].m_id = id;
+            thread.m_stack[depth].m_kind = (uint8_t)kind;
+        }
+    }
+
+    /**
+     * @brief Close the innermost span, called by the trace macros
+     * @param object Signal or slot
+     */
+    static void end(const void *object)
+    {
+        EventTraceThread &thread = localThread();
+        const uint16_t depth = --thread.m_depth;
+
+        if ((depth < EVENT_TRACE_MAX_DEPTH) && (thread.m_stack[depth].m_id != 0))
+        {
+            EventTraceBuffer &buffer = *thread.m_buffer;
+            write(buffer, buffer.m_count.load(std::memory_order_relaxed), object, thread.m_stack[depth].m_id, 0, End,
+                  (Kind)thread.m_stack[depth].m_kind);
+        }
+    }
+
+private: /* Methods */
+    static void write(EventTraceBuffer &buffer, uint32_t count, const void *object, uint64_t id, uint64_t parent,
+                      Phase phase, Kind kind)
+    {
+        EventTraceRecord &record = buffer.m_records[count];
+
+        record.m_timestamp_ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    std::chrono::steady_clock::now() - epoch())
+                                    .count();
+        record.m_object = object;
+        record.m_id = id;
+        record.m_parent = parent;
+        record.m_phase = (uint8_t)phase;
+        record.m_kind = (uint8_t)kind;
+        buffer.m_count.store(count + 1u, std::memory_order_release);
+    }
+
+    static uint64_t parentEmit(const EventTraceThread &thread, uint16_t depth)
+    {
+        while (depth > 0)
+        {
+            depth--;
+            if ((thread.m_stack[depth].m_kind == Emit) && (thread.m_stack[depth].m_id != 0))
+            {
+                return thread.m_stack[depth].m_id;
+            }
+        }
+        return 0;
+    }
+
+    static void writeName(FILE *file, const void *object, Kind kind)
+    {
+        std::map<const void *, std::string>::const_iterator it = names().find(object);
+
+        if (it == names().end())
+        {
+            fprintf(file, "%s %p", (kind == Emit) ? "Signal" : "Slot", object);
+            return;
+        }
+
+        for (std::string::const_iterator c = it->second.begin(); c != it->second.end(); ++c)
+        {
+            const unsigned char character = (unsigned char)*c;
+
+            if ((character == '"') || (character == '\\'))
+            {
+                fputc('\\', file);
+                fputc(character, file);
+            }
+            else if (character < 0x20u)
+            {
+                /* Control characters are not allowed in JSON strings */
+                fprintf(file, "\\u%04x", (unsigned)character);
+            }
+            else
+            {
+                fputc(character, file);
+            }
+        }
+    }
+
+    /**
+     * @brief Span stack of the calling thread
+     * @return EventTraceThread&
+     */
+    static EventTraceThread &localThread(void)
+    {
+        static thread_local EventTraceThread thread = {nullptr, {}, 0};
+        return thread;
+    }
+
+    /**
+     * @brief Buffer of the calling thread, created and registered on first use
+     * @param thread Span stack of the calling thread
+     * @return EventTraceBuffer&
+     */
+    static EventTraceBuffer &localBuffer(EventTraceThread &thread)
+    {
+        if (thread.m_buffer == nullptr)
+        {
+            static std::atomic<uint32_t> thread_count(0);
+            EventTraceBuffer *buffer = new EventTraceBuffer();
+
+            buffer->m_count.store(0, std::memory_order_relaxed);
+            buffer->m_dropped.store(0, std::memory_order_relaxed);
+            buffer->m_thread_index = thread_count.fetch_add(1, std::memory_order_relaxed) + 1u;
+            buffer->m_next_id = ((uint64_t)buffer->m_thread_index << 32) | 1u;
+            buffer->m_next = buffers().load(std::memory_order_relaxed);
+            while (!buffers().compare_exchange_weak(buffer->m_next, buffer, std::memory_order_release,
+                                                    std::memory_order_relaxed))
+            {
+            }
+            thread.m_buffer = buffer;
+        }
+        return *thread.m_buffer;
+    }
+
+    static std::atomic<EventTraceBuffer *> &buffers(void)
+    {
+        static std::atomic<EventTraceBuffer *> head(nullptr);
+        return head;
+    }
+
+    static std::atomic<bool> &enabled(void)
+    {
+        static std::atomic<bool> flag(false);
+        return flag;
+    }
+
+    static std::chrono::steady_clock::time_point epoch(void)
+    {
+        static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        return start;
+    }
+
+    static std::map<const void *, std::string> &names(void)
+    {
+        static std::map<const void *, std::string> map;
+        return map;
+    }
+
+    static std::mutex &namesMutex(void)
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+};
+
+/**
+ * @brief Trace hooks used by Signal::emit()
+ */
+#define EVENT_TRACE_EMIT_BEGIN(SIGNAL) EventTrace::begin((SIGNAL), EventTrace::Emit)
+#define EVENT_TRACE_EMIT_END(SIGNAL) EventTrace::end((SIGNAL))
+#define EVENT_TRACE_SLOT_BEGIN(SLOT) EventTrace::begin((SLOT), EventTrace::Invoke)
+#define EVENT_TRACE_SLOT_END(SLOT) EventTrace::end((SLOT))
+
+#else
+
+#define EVENT_TRACE_EMIT_BEGIN(SIGNAL) do {} while (0)
+#define EVENT_TRACE_EMIT_END(SIGNAL) do {} while (0)
+#define EVENT_TRACE_SLOT_BEGIN(SLOT) do {} while (0)
+#define EVENT_TRACE_SLOT_END(SLOT) do {} while (0)
+
+#endif
+
+#endif // EVENTTRACE_H
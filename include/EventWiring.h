@@ -0,0 +1,228 @@
+#ifndef EVENTWIRING_H
+#define EVENTWIRING_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "EventConnections.h"
+#include "EventSlot.h"
+
+/**
+ * @brief Forward decleartion of the clas Signal
+ */
+template <class... Type> class Signal;
+
+/**
+ * @brief Global Macro definiton of one entry of a wiring table
+ * @param SIGNAL Signal to connect
+ * @param SLOT_OR_SIGNAL Slot or signal to connect to
+ */
+#define EVENT_WIRE(SIGNAL, SLOT_OR_SIGNAL) EventWiring::wire((SIGNAL), (SLOT_OR_SIGNAL))
+
+/**
+ * @brief Bulk connection of many signals at startup
+ *
+ * Connecting signals one by one grows each connection block step by step. EventWiring takes a whole table of
+ * signal to slot / signal pairs instead, counts the connections of every signal, allocates the connection blocks of all
+ * signals of the table with one allocation (the arena) and fills them in one pass. Every block has exactly the size it
+ * needs; connections which already exist are moved into the new block, and the connection order of the table is kept.
+ *
+ * A signal which is connected again later moves to its own block. The arena is freed when neither the EventWiring object
+ * nor any signal uses it any more, so the wiring and the signals may be destroyed in any order.
+ *
+ * Example:
+ * @code
+ * EventWiring wiring;
+ * EventWiring::Entry table[] = {
+ *     EVENT_WIRE(sender.m_click_signal, receiver.m_onClick_slot),
+ *     EVENT_WIRE(sender.m_click_signal, other.m_onClick_slot),
+ * };
+ * wiring.apply(table, sizeof(table) / sizeof(table[0]));
+ * @endcode
+ */
+class EventWiring
+{
+public:
+    /**
+     * @brief One connection of a wiring table
+     */
+    struct Entry
+    {
+        EventConnections *m_signal; /*!< Connection storage of the emitting signal */
+        void *m_target;             /*!< Connected slot or signal */
+        bool m_is_signal;           /*!< Target is a signal */
+        uint32_t m_order;           /*!< Position in the table, keeps the connection order while sorting */
+    };
+
+    /**
+     * @brief Create a table entry connecting a signal to a slot
+     * @param[in] signal Signal to connect
+     * @param[in] slot Slot to connect
+     * @return Entry
+     */
+    template <class... Type>
+    static Entry wire(Signal<Type...> &signal, const Slot<Type...> &slot)
+    {
+        Entry entry = {&signal, const_cast<Slot<Type...> *>(&slot), false, 0};
+        return entry;
+    }
+
+    /**
+     * @brief Create a table entry connecting a signal to a signal
+     * @param[in] signal Signal to connect
+     * @param[in] target Signal to connect to
+     * @return Entry
+     */
+    template <class... Type>
+    static Entry wire(Signal<Type...> &signal, const Signal<Type...> &target)
+    {
+        Entry entry = {&signal, const_cast<Signal<Type...> *>(&target), true, 0};
+        return entry;
+    }
+
+    /**
+     * @brief Construct a new Wiring object
+     */
+    EventWiring() : m_arenas(nullptr)
+    {
+    }
+
+    EventWiring(const EventWiring &) = delete;
+    EventWiring &operator=(const EventWiring &) = delete;
+
+    /**
+     * @brief Destroy the Wiring object
+     *
+     * Arenas which still hold blocks of signals are freed by the last of these signals.
+     */
+    ~EventWiring()
+    {
+        while (m_arenas != nullptr)
+        {
+            EventConnectionArena *next = m_arenas->m_next;
+            EventConnectionArena::release(m_arenas);
+            m_arenas = next;
+        }
+    }
+
+    /**
+     * @brief Connect all entries of a table
+     * @param table Wiring table, it is sorted by signal in place
+     * @param count Number of entries
+     * @return uint32_t Number of connections made
+     *
+     * As with Signal::connect() entries beyond the maximum number of connections of a signal are dropped. Must not
+     * be called while one of the signals is emitting.
+     */
+    uint32_t apply(Entry *table, uint32_t count)
+    {
+        uint32_t bytes = sizeof(EventConnectionArena);
+        uint32_t connected = 0;
+
+        if (count == 0)
+        {
+            return 0;
+        }
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            table[i].m_order = i;
+        }
+        qsort(table, count, sizeof(Entry), &compareEntries);
+
+        /* Pass 1: size of the block of every signal */
+        for (uint32_t first = 0; first < count;)
+        {
+            uint32_t last = runEnd(table, first, count);
+            bytes += sizeof(EventConnectionArena *) + EventConnections::blockSize(capacityOf(table[first].m_signal, last - first));
+            first = last;
+        }
+
+        /* The first block starts behind the arena header, every block is preceded by a pointer to the header */
+        uint8_t *memory = new uint8_t[bytes];
+        EventConnectionArena *arena = new (memory) EventConnectionArena();
+        arena->m_next = m_arenas;
+        arena->m_users = 1;
+        m_arenas = arena;
+        memory += sizeof(EventConnectionArena);
+
+        /* Pass 2: move the existing connections and fill in the table */
+        for (uint32_t first = 0; first < count;)
+        {
+            uint32_t last = runEnd(table, first, count);
+            EventConnections *signal = table[first].m_signal;
+            const uint16_t capacity = capacityOf(signal, last - first);
+
+            if (capacity > signal->connectionCount())
+            {
+                *reinterpret_cast<EventConnectionArena **>(memory) = arena;
+                memory += sizeof(EventConnectionArena *);
+                arena->m_users++;
+                signal->install(memory, capacity, signal->maxConnections(), EventConnectionBlock::FLAG_ARENA);
+                memory += EventConnections::blockSize(capacity);
+
+                for (uint32_t i = first; i < last; i++)
+                {
+                    if (signal->connectEntry(table[i].m_target, table[i].m_is_signal, true))
+                    {
+                        connected++;
+                    }
+                }
+            }
+            first = last;
+        }
+        return connected;
+    }
+
+private: /* Methods */
+    /**
+     * @brief Order entries by signal, then by table position
+     */
+    static int compareEntries(const void *a, const void *b)
+    {
+        const Entry *lhs = static_cast<const Entry *>(a);
+        const Entry *rhs = static_cast<const Entry *>(b);
+        const uintptr_t lhs_signal = reinterpret_cast<uintptr_t>(lhs->m_signal);
+        const uintptr_t rhs_signal = reinterpret_cast<uintptr_t>(rhs->m_signal);
+
+        if (lhs_signal != rhs_signal)
+        {
+            return (lhs_signal < rhs_signal) ? -1 : 1;
+        }
+        return (lhs->m_order < rhs->m_order) ? -1 : ((lhs->m_order > rhs->m_order) ? 1 : 0);
+    }
+
+    /**
+     * @brief End of the run of entries of one signal
+     * @return uint32_t Index behind the last entry of the signal
+     */
+    static uint32_t runEnd(const Entry *table, uint32_t first, uint32_t count)
+    {
+        uint32_t last = first + 1u;
+        while ((last < count) && (table[last].m_signal == table[first].m_signal))
+        {
+            last++;
+        }
+        return last;
+    }
+
+    /**
+     * @brief Exact number of entries a signal needs after the wiring
+     * @param signal Connection storage of the signal
+     * @param new_connections Number of table entries of the signal
+     * @return uint16_t
+     */
+    static uint16_t capacityOf(const EventConnections *signal, uint32_t new_connections)
+    {
+        uint32_t capacity = (uint32_t)signal->connectionCount() + new_connections;
+        if (capacity > signal->maxConnections())
+        {
+            capacity = signal->maxConnections();
+        }
+        return (uint16_t)capacity;
+    }
+
+private:                          /*Parameter*/
+    EventConnectionArena *m_arenas; /*!< Arenas created by apply() */
+};
+
+#endif // EVENTWIRING_H
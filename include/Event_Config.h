@@ -15,6 +15,49 @@
 #endif
 
 
+#ifndef EVENT_CACHE_LINE_SIZE
+    #define EVENT_CACHE_LINE_SIZE               64u
+#endif
+
+
+#ifndef EVENT_TRACE_ENABLED
+    #define EVENT_TRACE_ENABLED                 0u
+#endif
+
+#ifndef EVENT_TRACE_BUFFER_SIZE
+    #define EVENT_TRACE_BUFFER_SIZE             16384u
+#endif
+
+#ifndef EVENT_TRACE_MAX_DEPTH
+    #define EVENT_TRACE_MAX_DEPTH               64u
+#endif
+
+
+#ifndef EVENT_TIMER_POOL_SIZE
+    #if (EVENT_USE_CPP_DEV_TYPE == EVENT_TYPE_EMBEDDED)
+        #define EVENT_TIMER_POOL_SIZE           8u
+    #else
+        #define EVENT_TIMER_POOL_SIZE           256u
+    #endif
+#endif
+
+#ifndef EVENT_TIMER_PAYLOAD_SIZE
+    #define EVENT_TIMER_PAYLOAD_SIZE            (4u * sizeof(void *) + 8u)
+#endif
+
+#ifndef EVENT_TIMER_WHEEL_BITS
+    #if (EVENT_USE_CPP_DEV_TYPE == EVENT_TYPE_EMBEDDED)
+        #define EVENT_TIMER_WHEEL_BITS          4u
+    #else
+        #define EVENT_TIMER_WHEEL_BITS          6u
+    #endif
+#endif
+
+#ifndef EVENT_TIMER_WHEEL_LEVELS
+    #define EVENT_TIMER_WHEEL_LEVELS            4u
+#endif
+
+
 
 #define EVENT_SIGNAL_PREFIX                 m_
 #define EVENT_SIGNAL_SUFFIX                 _signal